@@ -0,0 +1,337 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of @c c_crowd.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "crowd.hpp"
+    #include "world.hpp"
+
+    #include <algorithm>
+    #include <cmath>
+    #include <condition_variable>
+    #include <functional>
+    #include <mutex>
+    #include <stdexcept>
+    #include <thread>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+constexpr size_t g_crowdMinRangeSize {1024u}; //!< The fewest characters that are worth a worker's range.
+
+vector<thread>                         g_crowdWorkers            {}; //!< The worker threads.
+mutex                                  g_crowdMutex              {}; //!< Guards the task and the stopping flag.
+condition_variable                     g_crowdStartCondition     {}; //!< Wakes the workers when a task is given.
+condition_variable                     g_crowdDoneCondition      {}; //!< Wakes the giver when the workers are done.
+function<void(size_t, size_t, size_t)> g_crowdTask               {}; //!< Updates a range of characters.
+size_t                                 g_crowdTaskSize           {}; //!< The number of characters in the task.
+size_t                                 g_crowdRangeCount         {}; //!< The number of ranges in the task.
+uint64_t                               g_crowdTaskId             {}; //!< The ID of the latest task.
+size_t                                 g_busyCrowdWorkers        {}; //!< The workers still on the latest task.
+bool                                   g_areCrowdWorkersStopping {}; //!< True if the workers should stop.
+
+/***********************************************************************************************************************
+ * @brief Runs the task on one of its ranges.
+ * @param p_range The index of the range. A range beyond the task's ranges is empty.
+ **********************************************************************************************************************/
+void fg_runCrowdRange(size_t p_range)
+{
+    if (p_range >= g_crowdRangeCount)
+        return;
+
+    size_t l_begin {g_crowdTaskSize * p_range / g_crowdRangeCount};
+    size_t l_end   {g_crowdTaskSize * (p_range + 1u) / g_crowdRangeCount};
+
+    g_crowdTask(p_range, l_begin, l_end);
+}
+
+/***********************************************************************************************************************
+ * @brief The loop of a worker thread, which runs its range of every task until the workers are stopped.
+ * @param p_worker The worker's index. The first range belongs to the thread that gives the task.
+ **********************************************************************************************************************/
+void fg_runCrowdWorker(size_t p_worker)
+{
+    uint64_t l_taskId {};
+
+    while (true)
+    {
+        {
+            unique_lock l_lock {g_crowdMutex};
+            g_crowdStartCondition.wait
+            (l_lock, [&] {return g_areCrowdWorkersStopping || g_crowdTaskId != l_taskId;});
+
+            if (g_areCrowdWorkersStopping)
+                return;
+
+            l_taskId = g_crowdTaskId;
+        }
+
+        fg_runCrowdRange(p_worker + 1u);
+
+        {
+            lock_guard l_lock {g_crowdMutex};
+
+            if (--g_busyCrowdWorkers != 0u)
+                continue;
+        }
+
+        g_crowdDoneCondition.notify_one();
+    }
+}
+
+/***********************************************************************************************************************
+ * @param p_size The number of characters that a task covers.
+ * @return The number of ranges that the task is split into.
+ **********************************************************************************************************************/
+size_t fg_getCrowdRangeCount(size_t p_size)
+{
+    return min(g_crowdWorkers.size() + 1u, max(p_size / g_crowdMinRangeSize, static_cast<size_t>(1u)));
+}
+
+/***********************************************************************************************************************
+ * @brief Splits a task into fixed ranges, one for the calling thread and one for every worker, and waits until every
+ * range is done. A small task is run on the calling thread alone.
+ * @param p_size The number of characters that the task covers.
+ * @param p_task Updates a range of characters. Gets the range's index, and the range from the first character to one
+ * past the last.
+ **********************************************************************************************************************/
+void fg_runCrowdTask(size_t p_size, function<void(size_t, size_t, size_t)> p_task)
+{
+    size_t l_rangeCount {fg_getCrowdRangeCount(p_size)};
+
+    if (l_rangeCount == 1u)
+    {
+        p_task(0u, 0u, p_size);
+        return;
+    }
+
+    {
+        lock_guard l_lock {g_crowdMutex};
+        g_crowdTask = move(p_task);
+        g_crowdTaskSize = p_size;
+        g_crowdRangeCount = l_rangeCount;
+        g_busyCrowdWorkers = g_crowdWorkers.size();
+        ++g_crowdTaskId;
+    }
+
+    g_crowdStartCondition.notify_all();
+    fg_runCrowdRange(0u);
+
+    unique_lock l_lock {g_crowdMutex};
+    g_crowdDoneCondition.wait(l_lock, [] {return g_busyCrowdWorkers == 0u;});
+}
+
+}
+
+// Private members.
+#if 1
+
+    void c_crowd::f_updateRange
+    (size_t p_begin, size_t p_end, uint64_t p_time, bool p_isWorldEdited, vector<c_move> &p_moves)
+    {
+        for (size_t l_i {p_begin}; l_i != p_end; ++l_i)
+        {
+            if (v_states[l_i] == e_state::ev_atGoal)
+                continue;
+
+            // Like for a player character, an edit resets the health, and may have opened a way for the blocked.
+            if (p_isWorldEdited)
+            {
+                v_healths[l_i] = static_cast<unsigned char>(g_pfNodeMaxHealth);
+                v_states[l_i] = e_state::ev_moving;
+            }
+
+            if (v_states[l_i] == e_state::ev_blocked || p_time < v_nextMoveTimes[l_i])
+                continue;
+
+            e_pfNodeDir l_dir {};
+
+            if (!v_flowFields[l_i]->f_getNextStep(v_posXs[l_i], v_posYs[l_i], v_healths[l_i], l_dir))
+            {
+                v_states[l_i] = e_state::ev_blocked;
+                continue;
+            }
+
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dir)};
+            int l_x {v_posXs[l_i] + l_offsetX};
+            int l_y {v_posYs[l_i] + l_offsetY};
+
+            p_moves.push_back({static_cast<uint32_t>(l_i), v_posXs[l_i], v_posYs[l_i]});
+            v_posXs[l_i] = l_x;
+            v_posYs[l_i] = l_y;
+            v_healths[l_i] =
+            static_cast<unsigned char>(fg_isPosNearWall(l_x, l_y) ? g_pfNodeMaxHealth : v_healths[l_i] - 1);
+            v_nextMoveTimes[l_i] = p_time + v_moveIntervals[l_i];
+
+            if (pair {l_x, l_y} == v_flowFields[l_i]->f_getGoal())
+                v_states[l_i] = e_state::ev_atGoal;
+        }
+    }
+
+#endif
+
+// Public members.
+#if 1
+
+    size_t c_crowd::f_add(int p_x, int p_y, int p_goalX, int p_goalY, float p_tilesPerSecond)
+    {
+        if (!(p_tilesPerSecond > 0.f))
+            throw invalid_argument {"Failed to add a crowd character; the given speed is invalid."};
+
+        v_posXs.push_back(p_x);
+        v_posYs.push_back(p_y);
+        v_healths.push_back({});
+        v_states.push_back({});
+        v_nextMoveTimes.push_back({});
+        v_moveIntervals.push_back(max(static_cast<uint32_t>(lround(1000.f / p_tilesPerSecond)), 1u));
+        v_flowFields.push_back({});
+        v_plans.push_back({});
+
+        size_t l_index {v_posXs.size() - 1u};
+        v_grid.f_insert(static_cast<uint32_t>(l_index), p_x, p_y);
+        f_setGoal(l_index, p_goalX, p_goalY);
+        return l_index;
+    }
+
+    void c_crowd::f_setGoal(size_t p_index, int p_goalX, int p_goalY)
+    {
+        c_plan &l_plan {v_plans[p_index]};
+
+        if (l_plan.v_flowField && p_goalX == l_plan.v_goalX && p_goalY == l_plan.v_goalY)
+            return;
+
+        l_plan.v_goalX = p_goalX;
+        l_plan.v_goalY = p_goalY;
+        l_plan.v_flowField = fg_getPfFlowField(p_goalX, p_goalY);
+        l_plan.v_flowField->f_update();
+
+        bool l_isAtGoal {v_posXs[p_index] == p_goalX && v_posYs[p_index] == p_goalY};
+
+        v_flowFields[p_index] = l_plan.v_flowField.get();
+        v_healths[p_index] = static_cast<unsigned char>(g_pfNodeMaxHealth);
+        v_states[p_index] = l_isAtGoal ? e_state::ev_atGoal : e_state::ev_moving;
+    }
+
+    void c_crowd::f_clear()
+    {
+        v_posXs.clear();
+        v_posYs.clear();
+        v_healths.clear();
+        v_states.clear();
+        v_nextMoveTimes.clear();
+        v_moveIntervals.clear();
+        v_flowFields.clear();
+        v_plans.clear();
+        v_grid.f_clear();
+    }
+
+    size_t c_crowd::f_getSize() const
+    {
+        return v_posXs.size();
+    }
+
+    pair<int, int> c_crowd::f_getPos(size_t p_index) const
+    {
+        return {v_posXs[p_index], v_posYs[p_index]};
+    }
+
+    c_crowd::e_state c_crowd::f_getState(size_t p_index) const
+    {
+        return v_states[p_index];
+    }
+
+    void c_crowd::f_update(uint64_t p_time)
+    {
+        bool l_isWorldEdited {v_worldRevision != fg_getWorldRevision()};
+
+        // The flow fields are built on this thread, so that the moves only read them. A field which is shared by
+        // several characters is only rebuilt by the first.
+        if (l_isWorldEdited)
+        {
+            v_worldRevision = fg_getWorldRevision();
+
+            for (c_plan &l_plan : v_plans)
+                l_plan.v_flowField->f_update();
+        }
+
+        v_rangeMoves.resize(max(v_rangeMoves.size(), fg_getCrowdRangeCount(v_posXs.size())));
+
+        fg_runCrowdTask
+        (
+            v_posXs.size(),
+            [this, p_time, l_isWorldEdited](size_t p_range, size_t p_begin, size_t p_end)
+            {
+                f_updateRange(p_begin, p_end, p_time, l_isWorldEdited, v_rangeMoves[p_range]);
+            }
+        );
+
+        // The grid is shared by the ranges, so it's updated here. The ranges are in order, and so are the moves.
+        for (vector<c_move> &l_moves : v_rangeMoves)
+        {
+            for (const c_move &l_move : l_moves)
+            {
+                auto [l_x, l_y] {f_getPos(l_move.v_index)};
+                v_grid.f_move(l_move.v_index, l_move.v_fromX, l_move.v_fromY, l_x, l_y);
+            }
+
+            l_moves.clear();
+        }
+    }
+
+    void c_crowd::f_findInRect(int p_fromX, int p_fromY, int p_toX, int p_toY, vector<size_t> &p_indices)
+    {
+        vector<uint32_t> &l_indices {v_foundIndices};
+        l_indices.clear();
+        v_grid.f_findInRect(p_fromX, p_fromY, p_toX, p_toY, l_indices);
+
+        for (uint32_t l_index : l_indices)
+        {
+            if
+            (
+                v_posXs[l_index] >= p_fromX && v_posXs[l_index] < p_toX &&
+                v_posYs[l_index] >= p_fromY && v_posYs[l_index] < p_toY
+            )
+            {
+                p_indices.push_back(l_index);
+            }
+        }
+    }
+
+#endif
+
+void fg_startCrowdWorkers(size_t p_count)
+{
+    g_areCrowdWorkersStopping = false;
+
+    for (size_t l_i {}; l_i != p_count; ++l_i)
+        g_crowdWorkers.emplace_back(fg_runCrowdWorker, l_i);
+}
+
+void fg_stopCrowdWorkers()
+{
+    {
+        lock_guard l_lock {g_crowdMutex};
+        g_areCrowdWorkersStopping = true;
+    }
+
+    g_crowdStartCondition.notify_all();
+
+    for (thread &l_worker : g_crowdWorkers)
+        l_worker.join();
+
+    g_crowdWorkers.clear();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The header file of @c c_crowd.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "entityGrid.hpp"
+#include "pfFlowField.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+/***********************************************************************************************************************
+ * @brief The simulated characters which aren't controlled by the player, kept as a structure of arrays so that
+ * thousands of them can be updated every tick.
+ * @details Every character follows the flow field of its goal, which is shared with the other characters that head
+ * to the same goal. The data that every tick reads, such as the positions and the move times, is kept in an array per
+ * field. The goals and the ownership of the flow fields, which only change when a character gets a new goal, are kept
+ * apart from it.
+ *
+ * The moves are spread over the crowd's worker threads in fixed ranges of characters. A move only reads the world and
+ * the flow fields, and only writes its own character, so the results don't depend on the number of workers.
+ **********************************************************************************************************************/
+class c_crowd
+{
+    public:
+
+    enum class e_state : unsigned char {ev_moving, ev_blocked, ev_atGoal};
+
+    private:
+
+    /*******************************************************************************************************************
+     * @brief The data of a character which only changes with its goal.
+     ******************************************************************************************************************/
+    class c_plan
+    {
+        public:
+
+        int                            v_goalX     {}; //!< The goal's world-space tile X-position.
+        int                            v_goalY     {}; //!< The goal's world-space tile Y-position.
+        std::shared_ptr<c_pfFlowField> v_flowField {}; //!< The goal's flow field, which the character holds.
+    };
+
+    /*******************************************************************************************************************
+     * @brief A move of a character during an update, which the grid is updated with afterwards.
+     ******************************************************************************************************************/
+    class c_move
+    {
+        public:
+
+        uint32_t v_index {}; //!< The character's index.
+        int      v_fromX {}; //!< The world-space tile X-position that the character moved from.
+        int      v_fromY {}; //!< The world-space tile Y-position that the character moved from.
+    };
+
+    std::vector<int>                   v_posXs         {}; //!< The world-space tile X-position of every character.
+    std::vector<int>                   v_posYs         {}; //!< The world-space tile Y-position of every character.
+    std::vector<unsigned char>         v_healths       {}; //!< The health of every character's node.
+    std::vector<e_state>               v_states        {}; //!< The state of every character.
+    std::vector<uint64_t>              v_nextMoveTimes {}; //!< When every character may move next, in simulation time.
+    std::vector<uint32_t>              v_moveIntervals {}; //!< The milliseconds between every character's moves.
+    std::vector<const c_pfFlowField *> v_flowFields    {}; //!< The flow field of every character, owned by its plan.
+    std::vector<c_plan>                v_plans         {}; //!< The plan of every character.
+    uint64_t                           v_worldRevision {}; //!< The world's revision at the latest update.
+    c_entityGrid                       v_grid          {}; //!< The indices of the characters, by their positions.
+    std::vector<std::vector<c_move>>   v_rangeMoves    {}; //!< The moves of every range of the latest update.
+    std::vector<uint32_t>              v_foundIndices  {}; //!< The indices which were found in the grid.
+
+    /*******************************************************************************************************************
+     * @brief Moves the characters of a range whose moves are due. Called on a worker thread, so it only writes the
+     * range's characters.
+     * @param p_begin, p_end The range, from the first character to one past the last.
+     * @param p_time The simulation time.
+     * @param p_isWorldEdited True if the world has been edited since the previous update.
+     * @param p_moves Gets the moves of the range added to it.
+     ******************************************************************************************************************/
+    void f_updateRange
+    (size_t p_begin, size_t p_end, uint64_t p_time, bool p_isWorldEdited, std::vector<c_move> &p_moves);
+
+    public:
+
+    /*******************************************************************************************************************
+     * @brief Adds a character. May only be called on the main thread, outside of @c f_update.
+     * @param p_x, p_y The character's world-space tile position. Must be inside the world's boundaries.
+     * @param p_goalX, p_goalY The goal's world-space tile position. Must be inside the world's boundaries.
+     * @param p_tilesPerSecond The character's speed. Must be greater than 0.
+     * @return The character's index.
+     * @throw std::invalid_argument If @p p_tilesPerSecond is not greater than 0.
+     ******************************************************************************************************************/
+    size_t f_add(int p_x, int p_y, int p_goalX, int p_goalY, float p_tilesPerSecond);
+
+    /*******************************************************************************************************************
+     * @brief Gives a character a new goal, unless it already has the goal. May only be called on the main thread,
+     * outside of @c f_update.
+     * @param p_index The character's index.
+     * @param p_goalX, p_goalY The goal's world-space tile position. Must be inside the world's boundaries.
+     ******************************************************************************************************************/
+    void f_setGoal(size_t p_index, int p_goalX, int p_goalY);
+
+    /*******************************************************************************************************************
+     * @brief Removes every character.
+     ******************************************************************************************************************/
+    void f_clear();
+
+    /*******************************************************************************************************************
+     * @return The number of characters.
+     ******************************************************************************************************************/
+    size_t f_getSize() const;
+
+    /*******************************************************************************************************************
+     * @param p_index A character's index.
+     * @return The character's world-space tile position.
+     ******************************************************************************************************************/
+    std::pair<int, int> f_getPos(size_t p_index) const;
+
+    /*******************************************************************************************************************
+     * @param p_index A character's index.
+     * @return The character's state.
+     ******************************************************************************************************************/
+    e_state f_getState(size_t p_index) const;
+
+    /*******************************************************************************************************************
+     * @brief Gets the characters on a rectangle of tiles, looking only at the cells of the grid that overlap it.
+     * @param p_fromX, p_fromY The world-space tile position of the rectangle's top-left corner.
+     * @param p_toX, p_toY The world-space tile position one past the rectangle's bottom-right corner.
+     * @param p_indices Gets the characters' indices added to it.
+     ******************************************************************************************************************/
+    void f_findInRect(int p_fromX, int p_fromY, int p_toX, int p_toY, std::vector<size_t> &p_indices);
+
+    /*******************************************************************************************************************
+     * @brief Moves the characters whose moves are due. After a world edit, the flow fields are brought up to date on
+     * the calling thread first, and the blocked characters try again. May only be called on the main thread.
+     * @param p_time The simulation time, as in @c n_time::fg_getSimTime.
+     ******************************************************************************************************************/
+    void f_update(uint64_t p_time);
+};
+
+/***********************************************************************************************************************
+ * @brief Starts the crowd's worker threads. The thread that calls @c c_crowd::f_update takes a share of the moves too.
+ * @param p_count The number of workers.
+ **********************************************************************************************************************/
+void fg_startCrowdWorkers(size_t p_count);
+
+/***********************************************************************************************************************
+ * @brief Stops the crowd's worker threads.
+ **********************************************************************************************************************/
+void fg_stopCrowdWorkers();
+
+}
\ No newline at end of file
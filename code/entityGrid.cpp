@@ -0,0 +1,75 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of @c c_entityGrid.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "entityGrid.hpp"
+
+    #include <algorithm>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+// Public members.
+#if 1
+
+    c_entityGrid::c_entityGrid() : v_cells(static_cast<size_t>(fs_cellCountX) * static_cast<size_t>(fs_cellCountY))
+    {
+
+    }
+
+    void c_entityGrid::f_insert(uint32_t p_entity, int p_x, int p_y)
+    {
+        v_cells[fs_getCellIndex(p_x, p_y)].push_back(p_entity);
+    }
+
+    void c_entityGrid::f_erase(uint32_t p_entity, int p_x, int p_y)
+    {
+        vector<uint32_t> &l_entities {v_cells[fs_getCellIndex(p_x, p_y)]};
+        auto              l_entity   {find(l_entities.begin(), l_entities.end(), p_entity)};
+
+        if (l_entity == l_entities.end())
+            return;
+
+        *l_entity = l_entities.back();
+        l_entities.pop_back();
+    }
+
+    void c_entityGrid::f_clear()
+    {
+        for (vector<uint32_t> &l_entities : v_cells)
+            l_entities.clear();
+    }
+
+    void c_entityGrid::f_findInRect(int p_fromX, int p_fromY, int p_toX, int p_toY, vector<uint32_t> &p_entities) const
+    {
+        p_fromX = max(p_fromX, 0);
+        p_fromY = max(p_fromY, 0);
+        p_toX = min(p_toX, g_worldW);
+        p_toY = min(p_toY, g_worldH);
+
+        if (p_fromX >= p_toX || p_fromY >= p_toY)
+            return;
+
+        for (int l_cellX {p_fromX / fs_cellSize}; l_cellX <= (p_toX - 1) / fs_cellSize; ++l_cellX)
+        {
+            for (int l_cellY {p_fromY / fs_cellSize}; l_cellY <= (p_toY - 1) / fs_cellSize; ++l_cellY)
+            {
+                size_t l_cell {fs_getCellIndex(l_cellX * fs_cellSize, l_cellY * fs_cellSize)};
+                p_entities.insert(p_entities.end(), v_cells[l_cell].begin(), v_cells[l_cell].end());
+            }
+        }
+    }
+
+#endif
+
+}
\ No newline at end of file
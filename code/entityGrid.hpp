@@ -0,0 +1,104 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The header file of @c c_entityGrid.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "main.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+/***********************************************************************************************************************
+ * @brief A uniform grid of the world's entities, so that drawing and picking only look at the entities near the
+ * tiles they're interested in.
+ * @details The world is split into cells of 8 by 8 tiles, and every cell lists the entities on its tiles. An entity
+ * only changes cells on every 8th step of a straight line, so most moves don't touch the grid at all. The entities
+ * are identified by numbers which the owner of the grid gives them, and the grid doesn't know their positions within
+ * the cells.
+ **********************************************************************************************************************/
+class c_entityGrid
+{
+    private:
+
+    static constexpr int fs_cellSize   {8};                      //!< The width and height of a cell, in tiles.
+    static constexpr int fs_cellCountX {g_worldW / fs_cellSize}; //!< The number of cells on the X-axis.
+    static constexpr int fs_cellCountY {g_worldH / fs_cellSize}; //!< The number of cells on the Y-axis.
+
+    std::vector<std::vector<uint32_t>> v_cells {}; //!< The entities of every cell, indexed with @c fs_getCellIndex.
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return The index of the tile's cell in @c v_cells.
+     ******************************************************************************************************************/
+    static size_t fs_getCellIndex(int p_x, int p_y);
+
+    public:
+
+    /*******************************************************************************************************************
+     * @brief Creates a grid which covers the whole world, without entities.
+     ******************************************************************************************************************/
+    c_entityGrid();
+
+    /*******************************************************************************************************************
+     * @brief Adds an entity.
+     * @param p_entity The entity.
+     * @param p_x, p_y The entity's world-space tile position. Must be inside the world's boundaries.
+     ******************************************************************************************************************/
+    void f_insert(uint32_t p_entity, int p_x, int p_y);
+
+    /*******************************************************************************************************************
+     * @brief Removes an entity, if it's in the cell of the given position.
+     * @param p_entity The entity.
+     * @param p_x, p_y The entity's world-space tile position. Must be inside the world's boundaries.
+     ******************************************************************************************************************/
+    void f_erase(uint32_t p_entity, int p_x, int p_y);
+
+    /*******************************************************************************************************************
+     * @brief Moves an entity to the cell of its new position, if the cell has changed.
+     * @param p_entity The entity.
+     * @param p_fromX, p_fromY The entity's old world-space tile position. Must be inside the world's boundaries.
+     * @param p_toX, p_toY The entity's new world-space tile position. Must be inside the world's boundaries.
+     ******************************************************************************************************************/
+    void f_move(uint32_t p_entity, int p_fromX, int p_fromY, int p_toX, int p_toY);
+
+    /*******************************************************************************************************************
+     * @brief Removes every entity.
+     ******************************************************************************************************************/
+    void f_clear();
+
+    /*******************************************************************************************************************
+     * @brief Gets the entities of the cells which overlap a rectangle of tiles. The entities may be outside the
+     * rectangle, so the caller checks their positions.
+     * @param p_fromX, p_fromY The world-space tile position of the rectangle's top-left corner.
+     * @param p_toX, p_toY The world-space tile position one past the rectangle's bottom-right corner. The parts of the
+     * rectangle outside the world's boundaries are ignored.
+     * @param p_entities Gets the entities added to it.
+     ******************************************************************************************************************/
+    void f_findInRect(int p_fromX, int p_fromY, int p_toX, int p_toY, std::vector<uint32_t> &p_entities) const;
+};
+
+inline size_t c_entityGrid::fs_getCellIndex(int p_x, int p_y)
+{
+    return static_cast<size_t>(p_x / fs_cellSize) * static_cast<size_t>(fs_cellCountY) +
+    static_cast<size_t>(p_y / fs_cellSize);
+}
+
+inline void c_entityGrid::f_move(uint32_t p_entity, int p_fromX, int p_fromY, int p_toX, int p_toY)
+{
+    if (fs_getCellIndex(p_fromX, p_fromY) == fs_getCellIndex(p_toX, p_toY))
+        return;
+
+    f_erase(p_entity, p_fromX, p_fromY);
+    f_insert(p_entity, p_toX, p_toY);
+}
+
+}
\ No newline at end of file
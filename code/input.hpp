@@ -25,7 +25,10 @@ enum e_keybindIds
     ev_moveFaster,
     ev_placeWalls,
     ev_placeTargets,
-    ev_setPfGoal
+    ev_placeCharacters,
+    ev_setPfGoal,
+    ev_toggleCooperative,
+    ev_togglePfStats
 };
 
 //! IDs for keybind axes.
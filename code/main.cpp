@@ -7,9 +7,13 @@
 #if 1
 
     #include "main.hpp"
+    #include "crowd.hpp"
     #include "input.hpp"
     #include "time.hpp"
+    #include "pfJobs.hpp"
     #include "playerCharacter.hpp"
+    #include "tileImage.hpp"
+    #include "world.hpp"
 
     #include <algorithm>
     #include <array>
@@ -20,9 +24,11 @@
     #include <fstream>
     #include <iostream>
     #include <numbers>
+    #include <numeric>
+    #include <optional>
     #include <string>
+    #include <thread>
     #include <tuple>
-    #include <unordered_map>
 
     #include <SDL.h>
     #include <SDL_image.h>
@@ -48,7 +54,28 @@ SDL_Renderer *g_renderer {};    //!< The game window's renderer.
 float         g_windowW  {800}; //!< The game window's width in pixels.
 float         g_windowH  {600}; //!< The game window's height in pixels.
 
-unordered_map<string, SDL_Texture *> g_textures {}; //!< The game's textures.
+constexpr size_t g_noSprite {SIZE_MAX}; //!< The handle of a missing sprite.
+
+/***********************************************************************************************************************
+ * @brief A sprite, which is the rectangle of a texture file in the texture atlas.
+ **********************************************************************************************************************/
+class c_sprite
+{
+    public:
+
+    string     v_name    {}; //!< The texture file's path in the texture directory.
+    SDL_Rect   v_rect    {}; //!< The sprite's rectangle in the atlas, in pixels.
+    SDL_FPoint v_texFrom {}; //!< The texture coordinates of the rectangle's top-left corner.
+    SDL_FPoint v_texTo   {}; //!< The texture coordinates of the rectangle's bottom-right corner.
+    SDL_Color  v_color   {}; //!< The sprite's average colour, weighted by alpha. The alpha is the average alpha.
+};
+
+SDL_Texture     *g_atlas   {}; //!< The texture which every sprite is packed into.
+vector<c_sprite> g_sprites {}; //!< The sprites, indexed by their handles.
+
+size_t g_wallSprite            {g_noSprite}; //!< The handle of the wall's sprite.
+size_t g_targetSprite          {g_noSprite}; //!< The handle of the target's sprite.
+size_t g_playerCharacterSprite {g_noSprite}; //!< The handle of a character's sprite.
 
 float g_tileW {32.f}; //!< The width of a tile in pixels. Must be > 0. @sa fg_setTileSizeAndCenter
 float g_tileH {32.f}; //!< The height of a tile in pixels. Must be > 0. @sa fg_setTileSizeAndCenter
@@ -59,40 +86,250 @@ float g_viewportW {800.f}; //!< The viewport's width in pixels, without scaling.
 float g_viewportH {600.f}; //!< The viewport's height in pixels, without scaling. @sa fg_setViewportSizeAndCenter
 
 //! A placement mode, for @c g_currentPlacementMode.
-enum class e_placementMode {ev_walls, ev_targets};
+enum class e_placementMode {ev_walls, ev_targets, ev_characters};
 //! The current placement mode.
 e_placementMode g_currentPlacementMode {e_placementMode::ev_walls};
 
+constexpr uint64_t g_pfStatsInterval {1000u}; //!< How often the pathfinding statistics are printed, in milliseconds.
+
+bool     g_arePfStatsPrinted {}; //!< Whether the pathfinding statistics are printed. Toggled with a keybind.
+uint64_t g_nextPfStatsTime   {}; //!< The real time in milliseconds when the statistics are printed next.
+
+vector<c_playerCharacter *> g_visibleCharacters {}; //!< The player characters which are drawn on the frame.
+vector<size_t>              g_visibleCrowd      {}; //!< The crowd's characters which are drawn on the frame.
+
 /***********************************************************************************************************************
- * @brief Loads a texture from the given path.
- * @param p_path The path to the texture.
- * @return A pointer to the loaded texture. A @c nullptr on failure.
+ * @brief The view which the tile batch was built for. The batch is rebuilt when it changes.
  **********************************************************************************************************************/
-SDL_Texture *fg_loadTexture(const string &p_path)
+class c_tileBatchView
 {
-    SDL_Texture *l_texture        {};
-    SDL_Surface *l_textureSurface {IMG_Load(p_path.c_str())};
+    public:
+
+    int      v_fromX         {}; //!< The first visible tile's X-position.
+    int      v_fromY         {}; //!< The first visible tile's Y-position.
+    int      v_toX           {}; //!< The X-position one past the last visible tile.
+    int      v_toY           {}; //!< The Y-position one past the last visible tile.
+    float    v_viewportX     {}; //!< The viewport's X-position, in pixels.
+    float    v_viewportY     {}; //!< The viewport's Y-position, in pixels.
+    float    v_tileW         {}; //!< The width of a drawn tile, in pixels.
+    float    v_tileH         {}; //!< The height of a drawn tile, in pixels.
+    float    v_padX          {}; //!< The viewport's X-padding, in pixels.
+    float    v_padY          {}; //!< The viewport's Y-padding, in pixels.
+    uint64_t v_worldRevision {}; //!< The world's revision.
+
+    bool operator==(const c_tileBatchView &) const = default;
+};
+
+vector<SDL_Vertex> g_tileVertices {}; //!< The four corners of every visible static object, with its sprite's.
+vector<int>        g_tileIndices  {}; //!< The two triangles of every visible static object, in @c g_tileVertices.
+//! The view which the tile batch was built for. Empty before the first frame, or after the batch was used otherwise.
+optional<c_tileBatchView> g_tileBatchView {};
+
+constexpr int g_renderChunkSize   {32};                           //!< The width and height of a chunk, in tiles.
+constexpr int g_renderChunkCountX {g_worldW / g_renderChunkSize}; //!< The number of chunks on the X-axis.
+constexpr int g_renderChunkCountY {g_worldH / g_renderChunkSize}; //!< The number of chunks on the Y-axis.
+//! The largest size of a chunk's texture, in pixels. Zoomed in further, the static objects are batched every frame.
+constexpr int g_renderChunkMaxTextureSize {2048};
+//! The memory that the chunks' textures may take, in bytes. Beyond it, the textures of the chunks that have been out
+//! of view the longest are destroyed. The visible chunks' textures are kept even if they don't fit.
+constexpr size_t g_renderChunkMaxMemory {128u * 1024u * 1024u};
 
-    if (!l_textureSurface)
-        return nullptr;
+/***********************************************************************************************************************
+ * @brief A chunk of the world's static objects, rendered into a texture at the current zoom, so that a frame copies
+ * the texture instead of drawing the chunk's tiles.
+ **********************************************************************************************************************/
+class c_renderChunk
+{
+    public:
+
+    SDL_Texture *v_texture   {}; //!< The rendered chunk. A @c nullptr until rendered, and after a zoom or an eviction.
+    bool         v_isDirty   {}; //!< True if a static object of the chunk has changed since it was rendered.
+    uint64_t     v_drawFrame {}; //!< The value of @c g_renderChunkFrame when the chunk was last drawn.
+};
+
+//! The chunks, indexed with [X][Y].
+array<array<c_renderChunk, g_renderChunkCountY>, g_renderChunkCountX> g_renderChunks {};
+
+float                  g_renderChunkTileW    {}; //!< The width of a tile in the chunks' textures, in pixels.
+float                  g_renderChunkTileH    {}; //!< The height of a tile in the chunks' textures, in pixels.
+uint64_t               g_renderChunkRevision {}; //!< The world's revision that the chunks' dirtiness matches.
+vector<pair<int, int>> g_renderChunkEdits    {}; //!< The world's edits since @c g_renderChunkRevision.
+uint64_t               g_renderChunkFrame    {}; //!< The number of frames which have drawn the chunks.
 
-    l_texture = SDL_CreateTextureFromSurface(g_renderer, l_textureSurface);
-    SDL_FreeSurface(l_textureSurface);
+//! The tile size in pixels below which the world is drawn with a texel per tile, coloured by its static object. Set
+//! here, like the chunks' sizes.
+constexpr float g_lodTileSize {4.f};
 
-    if (!l_texture)
+c_tileImage            g_worldImage         {}; //!< The static objects, for zooming far out and for the minimap.
+uint64_t               g_worldImageRevision {}; //!< The world's revision that @c g_worldImage is up to date with.
+vector<pair<int, int>> g_worldImageEdits    {}; //!< The world's edits since @c g_worldImageRevision.
+
+constexpr float g_minimapMaxSize {256.f}; //!< The largest width and height of the minimap, in pixels.
+constexpr float g_minimapMargin  {8.f};   //!< The distance between the minimap and the window's corner, in pixels.
+
+c_tileImage            g_minimapAgents         {}; //!< The tiles which have characters on them.
+vector<pair<int, int>> g_minimapAgentPositions {}; //!< The characters' positions in @c g_minimapAgents, in order.
+//! The number of characters on every tile in @c g_minimapAgents, row by row.
+vector<uint32_t> g_minimapAgentCounts(static_cast<size_t>(g_worldW) * static_cast<size_t>(g_worldH));
+
+/***********************************************************************************************************************
+ * @brief Loads an image in the atlas's pixel format.
+ * @param p_path The path to the image.
+ * @return The image. A @c nullptr on failure.
+ **********************************************************************************************************************/
+SDL_Surface *fg_loadSurface(const string &p_path)
+{
+    SDL_Surface *l_loadedSurface {IMG_Load(p_path.c_str())};
+
+    if (!l_loadedSurface)
         return nullptr;
 
-    return l_texture;
+    SDL_Surface *l_surface {SDL_ConvertSurfaceFormat(l_loadedSurface, SDL_PIXELFORMAT_RGBA32, 0u)};
+    SDL_FreeSurface(l_loadedSurface);
+
+    return l_surface;
+}
+
+/***********************************************************************************************************************
+ * @param p_surface An image in the atlas's pixel format.
+ * @return The image's average colour, weighted by alpha, with the image's average alpha.
+ **********************************************************************************************************************/
+SDL_Color fg_getAverageColor(const SDL_Surface *p_surface)
+{
+    array<uint64_t, 4u> l_sums {};
+
+    for (int l_y {}; l_y != p_surface->h; ++l_y)
+    {
+        const auto *l_row {static_cast<const unsigned char *>(p_surface->pixels) + l_y * p_surface->pitch};
+
+        for (int l_x {}; l_x != p_surface->w; ++l_x)
+        {
+            const unsigned char *l_pixel {l_row + l_x * 4};
+
+            for (size_t l_i {}; l_i != 3u; ++l_i)
+                l_sums[l_i] += static_cast<uint64_t>(l_pixel[l_i]) * l_pixel[3];
+
+            l_sums[3] += l_pixel[3];
+        }
+    }
+
+    uint64_t l_pixelCount {static_cast<uint64_t>(max(p_surface->w * p_surface->h, 1))};
+    uint64_t l_alphaSum   {max(l_sums[3], uint64_t {1u})};
+
+    return
+    {
+        static_cast<Uint8>(l_sums[0] / l_alphaSum),
+        static_cast<Uint8>(l_sums[1] / l_alphaSum),
+        static_cast<Uint8>(l_sums[2] / l_alphaSum),
+        static_cast<Uint8>(l_sums[3] / l_pixelCount)
+    };
+}
+
+/***********************************************************************************************************************
+ * @brief Packs images into the texture atlas, and gives the sprites their rectangles and colours.
+ * @param p_surfaces The image of every sprite in @c g_sprites.
+ * @return True on success.
+ **********************************************************************************************************************/
+bool fg_packAtlas(const vector<SDL_Surface *> &p_surfaces)
+{
+    constexpr int l_spacing {1}; // Keeps a filtered sprite from bleeding into its neighbours.
+
+    int l_atlasW {1024};
+
+    for (const SDL_Surface *l_surface : p_surfaces)
+        l_atlasW = max(l_atlasW, l_surface->w);
+
+    // The sprites are packed on shelves, from the tallest to the lowest, so that a shelf wastes little height.
+
+    vector<size_t> l_order(p_surfaces.size());
+    iota(l_order.begin(), l_order.end(), 0u);
+    stable_sort
+    (l_order.begin(), l_order.end(), [&](size_t p_a, size_t p_b) {return p_surfaces[p_a]->h > p_surfaces[p_b]->h;});
+
+    int l_x      {};
+    int l_y      {};
+    int l_shelfH {};
+
+    for (size_t l_i : l_order)
+    {
+        if (l_x + p_surfaces[l_i]->w > l_atlasW)
+        {
+            l_x = 0;
+            l_y += l_shelfH + l_spacing;
+            l_shelfH = 0;
+        }
+
+        g_sprites[l_i].v_rect = {l_x, l_y, p_surfaces[l_i]->w, p_surfaces[l_i]->h};
+        l_x += p_surfaces[l_i]->w + l_spacing;
+        l_shelfH = max(l_shelfH, p_surfaces[l_i]->h);
+    }
+
+    int          l_atlasH       {max(l_y + l_shelfH, 1)};
+    SDL_Surface *l_atlasSurface {SDL_CreateRGBSurfaceWithFormat(0u, l_atlasW, l_atlasH, 32, SDL_PIXELFORMAT_RGBA32)};
+
+    if (!l_atlasSurface)
+        return false;
+
+    for (size_t l_i {}; l_i != p_surfaces.size(); ++l_i)
+    {
+        c_sprite &l_sprite {g_sprites[l_i]};
+        SDL_Rect  l_rect   {l_sprite.v_rect};
+
+        SDL_SetSurfaceBlendMode(p_surfaces[l_i], SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(p_surfaces[l_i], nullptr, l_atlasSurface, &l_rect);
+
+        l_sprite.v_color = fg_getAverageColor(p_surfaces[l_i]);
+
+        l_sprite.v_texFrom =
+        {static_cast<float>(l_sprite.v_rect.x) / l_atlasW, static_cast<float>(l_sprite.v_rect.y) / l_atlasH};
+        l_sprite.v_texTo =
+        {
+            static_cast<float>(l_sprite.v_rect.x + l_sprite.v_rect.w) / l_atlasW,
+            static_cast<float>(l_sprite.v_rect.y + l_sprite.v_rect.h) / l_atlasH
+        };
+    }
+
+    g_atlas = SDL_CreateTextureFromSurface(g_renderer, l_atlasSurface);
+    SDL_FreeSurface(l_atlasSurface);
+
+    if (!g_atlas)
+        return false;
+
+    SDL_SetTextureBlendMode(g_atlas, SDL_BLENDMODE_BLEND);
+
+    return true;
 }
 
 /***********************************************************************************************************************
- * @brief Loads the program's resources, such as textures.
+ * @param p_name A texture file's path in the texture directory.
+ * @return The handle of the texture's sprite. @c g_noSprite if there's no such sprite.
+ **********************************************************************************************************************/
+size_t fg_findSprite(string_view p_name)
+{
+    for (size_t l_i {}; l_i != g_sprites.size(); ++l_i)
+        if (g_sprites[l_i].v_name == p_name)
+            return l_i;
+
+    return g_noSprite;
+}
+
+/***********************************************************************************************************************
+ * @brief Loads the program's resources, such as textures. Every texture is packed into the texture atlas, and the
+ * sprites which are drawn every frame are resolved to their handles.
  * @return True on success.
  **********************************************************************************************************************/
 bool fg_loadResources()
 {
     constexpr string_view l_textureDir {"textures"};
 
+    vector<SDL_Surface *> l_surfaces {};
+
+    auto fl_freeSurfaces = [&]
+    {
+        for (SDL_Surface *l_surface : l_surfaces)
+            SDL_FreeSurface(l_surface);
+    };
+
     for (const auto &l_entry : filesystem::recursive_directory_iterator {l_textureDir})
     {
         if (l_entry.is_regular_file() && l_entry.path().extension().string() == ".png")
@@ -101,9 +338,9 @@ bool fg_loadResources()
 
             replace(l_textureName.begin(), l_textureName.end(), '\\', '/');
 
-            g_textures[l_textureName] = fg_loadTexture(l_entry.path().string());
+            SDL_Surface *l_surface {fg_loadSurface(l_entry.path().string())};
 
-            if (!g_textures[l_textureName])
+            if (!l_surface)
             {
                 cout << "Failed to load the texture \""
                      << l_textureName
@@ -111,15 +348,37 @@ bool fg_loadResources()
                      << SDL_GetError()
                      << '\n';
 
-                g_textures.erase(l_textureName);
+                fl_freeSurfaces();
 
                 return false;
             }
 
+            g_sprites.push_back({l_textureName});
+            l_surfaces.push_back(l_surface);
+
             cout << "Loaded the texture \"" << l_textureName << "\".\n";
         }
     }
 
+    bool l_isPacked {fg_packAtlas(l_surfaces)};
+    fl_freeSurfaces();
+
+    if (!l_isPacked)
+    {
+        cout << "Failed to create the texture atlas. SDL Error: " << SDL_GetError() << '\n';
+        return false;
+    }
+
+    g_wallSprite = fg_findSprite("tex_wall_32x32.png");
+    g_targetSprite = fg_findSprite("tex_target_16x16.png");
+    g_playerCharacterSprite = fg_findSprite("tex_playerCharacter_32x32.png");
+
+    if (g_wallSprite == g_noSprite || g_targetSprite == g_noSprite || g_playerCharacterSprite == g_noSprite)
+    {
+        cout << "A texture which is drawn is missing.\n";
+        return false;
+    }
+
     return true;
 }
 
@@ -135,6 +394,8 @@ void fg_generateWorld()
                 g_staticObjs[l_x][l_y] = 1u; else
                 g_staticObjs[l_x][l_y] = 0u;
         }
+
+    fg_markWholeWorldChanged();
 }
 
 /***********************************************************************************************************************
@@ -199,16 +460,46 @@ bool fg_init()
 
     fg_generateWorld();
 
+    // The workers. One core is left for the main thread, and the rest are split between the pathfinding's workers and
+    // the crowd's, so that the threads don't outnumber the cores. The pathfinding gets the odd core, since the main
+    // thread takes a share of the crowd's moves too.
+
+    unsigned l_spareCores {max(1u, thread::hardware_concurrency()) - 1u};
+    unsigned l_pfWorkers  {(l_spareCores + 1u) / 2u};
+
+    fg_startPfWorkers(l_pfWorkers);
+    fg_startCrowdWorkers(l_spareCores - l_pfWorkers);
+
     return true;
 }
 
+/***********************************************************************************************************************
+ * @brief Destroys the textures of the chunks, so that they're rendered again when they're visible.
+ **********************************************************************************************************************/
+void fg_destroyRenderChunks()
+{
+    for (auto &l_column : g_renderChunks)
+    {
+        for (c_renderChunk &l_chunk : l_column)
+        {
+            SDL_DestroyTexture(l_chunk.v_texture);
+            l_chunk.v_texture = nullptr;
+        }
+    }
+}
+
 /***********************************************************************************************************************
  * @brief Prepares the program for termination.
  **********************************************************************************************************************/
 void fg_prepareForTermination()
 {
-    for (const auto &[l_key, l_texture] : g_textures)
-        SDL_DestroyTexture(l_texture);
+    fg_stopCrowdWorkers();
+    fg_stopPfWorkers();
+
+    fg_destroyRenderChunks();
+    g_minimapAgents.f_destroyTexture();
+    g_worldImage.f_destroyTexture();
+    SDL_DestroyTexture(g_atlas);
 
     SDL_DestroyRenderer(g_renderer);
     SDL_DestroyWindow(g_window);
@@ -307,47 +598,492 @@ void fg_setTileSizeAndCenter(float p_w, float p_h)
 }
 
 /***********************************************************************************************************************
- * @brief Draws the tiles of the given position. Used in @c fg_drawWorld.
+ * @brief Adds the static object of the given position to the tile batch. Used in @c fg_drawWorld.
  * @param p_x, p_y The position of the drawable tiles, in tile units.
  * @param p_viewportX, p_viewportY The position of the viewport, in pixels.
  * @param p_tileW, p_tileH The width and height of the drawable tiles, in pixels.
  * @param p_padX, p_padY The X-padding and Y-padding of the viewport, in pixels.
- * @todo The player characters are drawn here. This should probably be done differently.
  **********************************************************************************************************************/
-void fg_drawTile
+void fg_batchTile
 (int p_x, int p_y, float p_viewportX, float p_viewportY, float p_tileW, float p_tileH, float p_padX, float p_padY)
 {
-    auto fl_drawCenteredTexture = [&](const string &l_textureName, int p_textureW, int p_textureH)
+    size_t l_spriteHandle {};
+
+    switch (g_staticObjs[p_x][p_y])
     {
-        auto &l_texture {g_textures[l_textureName]};
-        float l_textureWRatio {static_cast<float>(p_textureW) / 32.f};
-        float l_textureHRatio {static_cast<float>(p_textureH) / 32.f};
+        case 1u: l_spriteHandle = g_wallSprite; break;
+        case 2u: l_spriteHandle = g_targetSprite; break;
+        default: return;
+    }
 
-        float l_posOffsetMultX {.5f - l_textureWRatio * .5f};
-        float l_posOffsetMultY {.5f - l_textureHRatio * .5f};
+    const c_sprite &l_sprite {g_sprites[l_spriteHandle]};
+
+    float l_textureWRatio {static_cast<float>(l_sprite.v_rect.w) / 32.f};
+    float l_textureHRatio {static_cast<float>(l_sprite.v_rect.h) / 32.f};
+
+    float l_posOffsetMultX {.5f - l_textureWRatio * .5f};
+    float l_posOffsetMultY {.5f - l_textureHRatio * .5f};
+
+    // The corners are at the same fractional positions as the chunks, the texels and the characters. A sprite that
+    // fills its tile shares the exact edges with the neighbouring tiles, so that the tiles don't get seams.
+    float l_tileLeft   {static_cast<float>(p_x) * p_tileW + p_padX - p_viewportX};
+    float l_tileTop    {static_cast<float>(p_y) * p_tileH + p_padY - p_viewportY};
+    float l_tileRight  {static_cast<float>(p_x + 1) * p_tileW + p_padX - p_viewportX};
+    float l_tileBottom {static_cast<float>(p_y + 1) * p_tileH + p_padY - p_viewportY};
+    float l_left       {l_tileLeft + (l_tileRight - l_tileLeft) * l_posOffsetMultX};
+    float l_top        {l_tileTop + (l_tileBottom - l_tileTop) * l_posOffsetMultY};
+    float l_right      {l_tileRight - (l_tileRight - l_tileLeft) * l_posOffsetMultX};
+    float l_bottom     {l_tileBottom - (l_tileBottom - l_tileTop) * l_posOffsetMultY};
+
+    constexpr SDL_Color l_color {255u, 255u, 255u, 255u};
+    int                 l_first {static_cast<int>(g_tileVertices.size())};
+    SDL_FPoint          l_from  {l_sprite.v_texFrom};
+    SDL_FPoint          l_to    {l_sprite.v_texTo};
+
+    g_tileVertices.push_back({{l_left, l_top}, l_color, {l_from.x, l_from.y}});
+    g_tileVertices.push_back({{l_right, l_top}, l_color, {l_to.x, l_from.y}});
+    g_tileVertices.push_back({{l_right, l_bottom}, l_color, {l_to.x, l_to.y}});
+    g_tileVertices.push_back({{l_left, l_bottom}, l_color, {l_from.x, l_to.y}});
+    g_tileIndices.insert(g_tileIndices.end(), {l_first, l_first + 1, l_first + 2, l_first + 2, l_first + 3, l_first});
+}
 
-        SDL_Rect l_renderRect
+/***********************************************************************************************************************
+ * @brief Draws the visible static objects in one batch, which is only rebuilt when the view or the world has changed.
+ * @param p_view The view.
+ **********************************************************************************************************************/
+void fg_drawTileBatch(const c_tileBatchView &p_view)
+{
+    if (g_tileBatchView != p_view)
+    {
+        g_tileBatchView = p_view;
+        g_tileVertices.clear();
+        g_tileIndices.clear();
+
+        for (int l_y {max(p_view.v_fromY, 0)}; l_y < min(p_view.v_toY, g_worldH); ++l_y)
         {
-            static_cast<int>(static_cast<float>(p_x) * p_tileW + p_padX - p_viewportX + p_tileW * l_posOffsetMultX),
-            static_cast<int>(static_cast<float>(p_y) * p_tileH + p_padY - p_viewportY + p_tileH * l_posOffsetMultY),
-            static_cast<int>(ceil(p_tileW * l_textureWRatio)),
-            static_cast<int>(ceil(p_tileH * l_textureHRatio))
-        };
+            for (int l_x {max(p_view.v_fromX, 0)}; l_x < min(p_view.v_toX, g_worldW); ++l_x)
+            {
+                fg_batchTile
+                (
+                    l_x,
+                    l_y,
+                    p_view.v_viewportX,
+                    p_view.v_viewportY,
+                    p_view.v_tileW,
+                    p_view.v_tileH,
+                    p_view.v_padX,
+                    p_view.v_padY
+                );
+            }
+        }
+    }
 
-        SDL_RenderCopy(g_renderer, l_texture, nullptr, &l_renderRect);
-    };
+    if (g_tileIndices.empty())
+        return;
+
+    SDL_RenderGeometry
+    (
+        g_renderer,
+        g_atlas,
+        g_tileVertices.data(),
+        static_cast<int>(g_tileVertices.size()),
+        g_tileIndices.data(),
+        static_cast<int>(g_tileIndices.size())
+    );
+}
+
+/***********************************************************************************************************************
+ * @brief Renders the static objects of a chunk into its texture, which is created if it doesn't exist.
+ * @param p_chunkX, p_chunkY The chunk's position, in chunks.
+ * @param p_w, p_h The size of the chunk's texture, in pixels.
+ * @return True on success.
+ **********************************************************************************************************************/
+bool fg_renderChunk(int p_chunkX, int p_chunkY, int p_w, int p_h)
+{
+    c_renderChunk &l_chunk {g_renderChunks[p_chunkX][p_chunkY]};
+
+    if (!l_chunk.v_texture)
+    {
+        l_chunk.v_texture = SDL_CreateTexture(g_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, p_w, p_h);
+
+        if (!l_chunk.v_texture)
+            return false;
+
+        SDL_SetTextureBlendMode(l_chunk.v_texture, SDL_BLENDMODE_BLEND);
+    }
+
+    // The tiles are batched with the chunk's corner as the viewport, which takes the tile batch's buffers. They're
+    // stretched to fill the whole pixels of the texture, which is scaled back to the chunk's exact size when drawn.
+
+    int   l_fromX     {p_chunkX * g_renderChunkSize};
+    int   l_fromY     {p_chunkY * g_renderChunkSize};
+    float l_tileW     {static_cast<float>(p_w) / g_renderChunkSize};
+    float l_tileH     {static_cast<float>(p_h) / g_renderChunkSize};
+    float l_viewportX {static_cast<float>(l_fromX) * l_tileW};
+    float l_viewportY {static_cast<float>(l_fromY) * l_tileH};
+
+    g_tileBatchView.reset();
+    g_tileVertices.clear();
+    g_tileIndices.clear();
+
+    for (int l_y {l_fromY}; l_y != l_fromY + g_renderChunkSize; ++l_y)
+        for (int l_x {l_fromX}; l_x != l_fromX + g_renderChunkSize; ++l_x)
+            fg_batchTile(l_x, l_y, l_viewportX, l_viewportY, l_tileW, l_tileH, 0.f, 0.f);
+
+    // The sprites are copied into the transparent texture as they are, so that their alpha isn't applied twice when
+    // the chunk is drawn.
+
+    SDL_SetRenderTarget(g_renderer, l_chunk.v_texture);
+    SDL_SetRenderDrawColor(g_renderer, 0u, 0u, 0u, 0u);
+    SDL_RenderClear(g_renderer);
+
+    if (!g_tileIndices.empty())
+    {
+        SDL_SetTextureBlendMode(g_atlas, SDL_BLENDMODE_NONE);
+        SDL_RenderGeometry
+        (
+            g_renderer,
+            g_atlas,
+            g_tileVertices.data(),
+            static_cast<int>(g_tileVertices.size()),
+            g_tileIndices.data(),
+            static_cast<int>(g_tileIndices.size())
+        );
+        SDL_SetTextureBlendMode(g_atlas, SDL_BLENDMODE_BLEND);
+    }
+
+    SDL_SetRenderTarget(g_renderer, nullptr);
+    l_chunk.v_isDirty = false;
+
+    return true;
+}
+
+/***********************************************************************************************************************
+ * @brief Draws the visible static objects by copying the textures of their chunks. A chunk is rendered when it is
+ * first visible, when one of its static objects changes, and when the zoom changes. The textures are kept when the
+ * chunks go out of view, up to @c g_renderChunkMaxMemory, so that panning back doesn't render them again.
+ * @param p_view The view.
+ * @return True on success. False if a chunk's texture couldn't be created.
+ **********************************************************************************************************************/
+bool fg_drawRenderChunks(const c_tileBatchView &p_view)
+{
+    if (p_view.v_tileW != g_renderChunkTileW || p_view.v_tileH != g_renderChunkTileH)
+    {
+        fg_destroyRenderChunks();
+        g_renderChunkTileW = p_view.v_tileW;
+        g_renderChunkTileH = p_view.v_tileH;
+    }
+
+    // Marks the edited chunks dirty. If the edits are no longer known, every chunk is.
+
+    if (g_renderChunkRevision != p_view.v_worldRevision)
+    {
+        g_renderChunkEdits.clear();
+        bool l_areEditsKnown {fg_getWorldEditsSince(g_renderChunkRevision, g_renderChunkEdits)};
+        g_renderChunkRevision = p_view.v_worldRevision;
+
+        for (auto &l_column : g_renderChunks)
+            for (c_renderChunk &l_chunk : l_column)
+                l_chunk.v_isDirty = l_chunk.v_isDirty || !l_areEditsKnown;
+
+        for (auto [l_x, l_y] : g_renderChunkEdits)
+            g_renderChunks[l_x / g_renderChunkSize][l_y / g_renderChunkSize].v_isDirty = true;
+    }
+
+    int l_chunkW {static_cast<int>(ceil(g_renderChunkTileW * g_renderChunkSize))};
+    int l_chunkH {static_cast<int>(ceil(g_renderChunkTileH * g_renderChunkSize))};
+
+    int l_fromX {max(p_view.v_fromX, 0) / g_renderChunkSize};
+    int l_fromY {max(p_view.v_fromY, 0) / g_renderChunkSize};
+    int l_toX   {(min(p_view.v_toX, g_worldW) + g_renderChunkSize - 1) / g_renderChunkSize};
+    int l_toY   {(min(p_view.v_toY, g_worldH) + g_renderChunkSize - 1) / g_renderChunkSize};
+
+    ++g_renderChunkFrame;
+
+    for (int l_chunkX {l_fromX}; l_chunkX < l_toX; ++l_chunkX)
+    {
+        for (int l_chunkY {l_fromY}; l_chunkY < l_toY; ++l_chunkY)
+        {
+            c_renderChunk &l_chunk {g_renderChunks[l_chunkX][l_chunkY]};
+
+            if ((!l_chunk.v_texture || l_chunk.v_isDirty) && !fg_renderChunk(l_chunkX, l_chunkY, l_chunkW, l_chunkH))
+                return false;
+
+            l_chunk.v_drawFrame = g_renderChunkFrame;
+
+            // At the same fractional position and size as the tiles, so that the chunks meet without seams and line
+            // up with the characters.
+
+            float     l_tileX {static_cast<float>(l_chunkX * g_renderChunkSize)};
+            float     l_tileY {static_cast<float>(l_chunkY * g_renderChunkSize)};
+            SDL_FRect l_renderRect
+            {
+                l_tileX * g_renderChunkTileW + p_view.v_padX - p_view.v_viewportX,
+                l_tileY * g_renderChunkTileH + p_view.v_padY - p_view.v_viewportY,
+                g_renderChunkSize * g_renderChunkTileW,
+                g_renderChunkSize * g_renderChunkTileH
+            };
+
+            SDL_RenderCopyF(g_renderer, l_chunk.v_texture, nullptr, &l_renderRect);
+        }
+    }
+
+    // The textures that have been out of view the longest are destroyed until the rest fit in the memory. The chunks
+    // are all the same size, so the memory is counted in textures.
 
-    for (const auto &l_i : g_playerCharacters)
+    size_t l_textureSize {static_cast<size_t>(l_chunkW) * static_cast<size_t>(l_chunkH) * 4u};
+    size_t l_maxTextures {g_renderChunkMaxMemory / l_textureSize};
+    size_t l_textures    {};
+
+    for (auto &l_column : g_renderChunks)
+        for (c_renderChunk &l_chunk : l_column)
+            l_textures += l_chunk.v_texture ? 1u : 0u;
+
+    while (l_textures > l_maxTextures)
     {
-        if (l_i.f_getPos().first == p_x && l_i.f_getPos().second == p_y)
-            fl_drawCenteredTexture("tex_playerCharacter_32x32.png", 32, 32);
+        c_renderChunk *l_oldestChunk {};
+
+        for (auto &l_column : g_renderChunks)
+        {
+            for (c_renderChunk &l_chunk : l_column)
+            {
+                if
+                (
+                    l_chunk.v_texture && l_chunk.v_drawFrame != g_renderChunkFrame &&
+                    (!l_oldestChunk || l_chunk.v_drawFrame < l_oldestChunk->v_drawFrame)
+                )
+                {
+                    l_oldestChunk = &l_chunk;
+                }
+            }
+        }
+
+        if (!l_oldestChunk)
+            break;
+
+        SDL_DestroyTexture(l_oldestChunk->v_texture);
+        l_oldestChunk->v_texture = nullptr;
+        --l_textures;
     }
 
+    return true;
+}
+
+/***********************************************************************************************************************
+ * @param p_x, p_y A world-space tile position inside the world's boundaries.
+ * @return The tile's texel in @c g_worldImage, which is its static object's sprite's colour, with the alpha scaled by
+ * the part of the tile that the sprite covers. Transparent for the empty static object.
+ **********************************************************************************************************************/
+uint32_t fg_getWorldImageTexel(int p_x, int p_y)
+{
+    size_t l_spriteHandle {};
+
     switch (g_staticObjs[p_x][p_y])
     {
-        case 1u: fl_drawCenteredTexture("tex_wall_32x32.png", 32, 32); break;
-        case 2u: fl_drawCenteredTexture("tex_target_16x16.png", 16, 16); break;
+        case 1u: l_spriteHandle = g_wallSprite; break;
+        case 2u: l_spriteHandle = g_targetSprite; break;
+        default: return 0u;
+    }
+
+    const c_sprite &l_sprite   {g_sprites[l_spriteHandle]};
+    float           l_coverage {min(static_cast<float>(l_sprite.v_rect.w * l_sprite.v_rect.h) / (32.f * 32.f), 1.f)};
+    uint32_t        l_alpha    {static_cast<uint32_t>(lround(static_cast<float>(l_sprite.v_color.a) * l_coverage))};
+
+    return
+    static_cast<uint32_t>(l_sprite.v_color.r) << 24u |
+    static_cast<uint32_t>(l_sprite.v_color.g) << 16u |
+    static_cast<uint32_t>(l_sprite.v_color.b) << 8u |
+    l_alpha;
+}
+
+/***********************************************************************************************************************
+ * @brief Brings @c g_worldImage up to date with the world. Only the tiles which have been edited since the previous
+ * time are set, and only their rows are uploaded.
+ * @return True on success. False if the image's texture couldn't be created.
+ **********************************************************************************************************************/
+bool fg_updateWorldImage()
+{
+    if (!g_worldImage.f_createTexture(g_renderer))
+        return false;
+
+    if (g_worldImageRevision != fg_getWorldRevision())
+    {
+        g_worldImageEdits.clear();
+
+        if (!fg_getWorldEditsSince(g_worldImageRevision, g_worldImageEdits))
+        {
+            g_worldImageEdits.clear();
+
+            for (int l_y {}; l_y != g_worldH; ++l_y)
+                for (int l_x {}; l_x != g_worldW; ++l_x)
+                    g_worldImageEdits.push_back({l_x, l_y});
+        }
+
+        g_worldImageRevision = fg_getWorldRevision();
+
+        for (auto [l_x, l_y] : g_worldImageEdits)
+            g_worldImage.f_setTexel(l_x, l_y, fg_getWorldImageTexel(l_x, l_y));
     }
+
+    g_worldImage.f_upload();
+
+    return true;
+}
+
+/***********************************************************************************************************************
+ * @brief Draws the visible static objects from @c g_worldImage, in a single copy.
+ * @param p_view The view.
+ **********************************************************************************************************************/
+void fg_drawLod(const c_tileBatchView &p_view)
+{
+    int l_fromX {max(p_view.v_fromX, 0)};
+    int l_fromY {max(p_view.v_fromY, 0)};
+    int l_toX   {min(p_view.v_toX, g_worldW)};
+    int l_toY   {min(p_view.v_toY, g_worldH)};
+
+    if (l_fromX >= l_toX || l_fromY >= l_toY)
+        return;
+
+    SDL_Rect  l_sourceRect {l_fromX, l_fromY, l_toX - l_fromX, l_toY - l_fromY};
+    SDL_FRect l_renderRect
+    {
+        static_cast<float>(l_fromX) * p_view.v_tileW + p_view.v_padX - p_view.v_viewportX,
+        static_cast<float>(l_fromY) * p_view.v_tileH + p_view.v_padY - p_view.v_viewportY,
+        static_cast<float>(l_toX - l_fromX) * p_view.v_tileW,
+        static_cast<float>(l_toY - l_fromY) * p_view.v_tileH
+    };
+
+    SDL_RenderCopyF(g_renderer, g_worldImage.f_getTexture(), &l_sourceRect, &l_renderRect);
+}
+
+/***********************************************************************************************************************
+ * @return The minimap's rectangle in the window's top-right corner, in pixels. The world's longer side gets at most
+ * @c g_minimapMaxSize pixels, or a third of the window's shorter side.
+ **********************************************************************************************************************/
+SDL_FRect fg_getMinimapRect()
+{
+    float l_size  {min(g_minimapMaxSize, min(g_windowW, g_windowH) / 3.f)};
+    float l_scale {l_size / static_cast<float>(max(g_worldW, g_worldH))};
+    float l_w     {static_cast<float>(g_worldW) * l_scale};
+    float l_h     {static_cast<float>(g_worldH) * l_scale};
+
+    return {g_windowW - g_minimapMargin - l_w, g_minimapMargin, l_w, l_h};
+}
+
+/***********************************************************************************************************************
+ * @param p_x, p_y A window-space position.
+ * @return The world-space position which the window-space position is on in the minimap. Empty if the window-space
+ * position isn't on the minimap.
+ **********************************************************************************************************************/
+optional<pair<float, float>> fg_getMinimapWorldPos(float p_x, float p_y)
+{
+    SDL_FRect l_rect {fg_getMinimapRect()};
+
+    if (p_x < l_rect.x || p_y < l_rect.y || p_x >= l_rect.x + l_rect.w || p_y >= l_rect.y + l_rect.h)
+        return {};
+
+    return pair
+    {
+        (p_x - l_rect.x) / l_rect.w * static_cast<float>(g_worldW),
+        (p_y - l_rect.y) / l_rect.h * static_cast<float>(g_worldH)
+    };
+}
+
+/***********************************************************************************************************************
+ * @brief Brings @c g_minimapAgents up to date with the characters' positions. Only the tiles of the characters which
+ * have moved, been added or been removed since the previous time are set, and only their rows are uploaded.
+ * @return True on success. False if the image's texture couldn't be created.
+ **********************************************************************************************************************/
+bool fg_updateMinimapAgents()
+{
+    if (!g_minimapAgents.f_createTexture(g_renderer))
+        return false;
+
+    const SDL_Color &l_color {g_sprites[g_playerCharacterSprite].v_color};
+    uint32_t         l_texel
+    {
+        static_cast<uint32_t>(l_color.r) << 24u |
+        static_cast<uint32_t>(l_color.g) << 16u |
+        static_cast<uint32_t>(l_color.b) << 8u |
+        0xFFu
+    };
+
+    auto fl_addToCount = [&](pair<int, int> p_pos, uint32_t p_amount)
+    {
+        auto [l_x, l_y] {p_pos};
+        uint32_t &l_count {g_minimapAgentCounts[static_cast<size_t>(l_y) * g_worldW + static_cast<size_t>(l_x)]};
+        l_count += p_amount;
+        g_minimapAgents.f_setTexel(l_x, l_y, l_count == 0u ? 0u : l_texel);
+    };
+
+    // The counts are of the previous positions, so replacing a previous position with a new one keeps them right,
+    // whichever character the positions belong to.
+
+    size_t l_prevCount {g_minimapAgentPositions.size()};
+    size_t l_count     {g_playerCharacters.size() + g_crowd.f_getSize()};
+
+    for (size_t l_i {l_count}; l_i < l_prevCount; ++l_i)
+        fl_addToCount(g_minimapAgentPositions[l_i], static_cast<uint32_t>(-1));
+
+    g_minimapAgentPositions.resize(l_count);
+
+    auto fl_setPos = [&](size_t p_i, pair<int, int> p_pos)
+    {
+        if (p_i < l_prevCount)
+        {
+            if (g_minimapAgentPositions[p_i] == p_pos)
+                return;
+
+            fl_addToCount(g_minimapAgentPositions[p_i], static_cast<uint32_t>(-1));
+        }
+
+        fl_addToCount(p_pos, 1u);
+        g_minimapAgentPositions[p_i] = p_pos;
+    };
+
+    for (size_t l_i {}; l_i != g_playerCharacters.size(); ++l_i)
+        fl_setPos(l_i, g_playerCharacters[l_i].f_getPos());
+
+    for (size_t l_i {}; l_i != g_crowd.f_getSize(); ++l_i)
+        fl_setPos(g_playerCharacters.size() + l_i, g_crowd.f_getPos(l_i));
+
+    g_minimapAgents.f_upload();
+
+    return true;
+}
+
+/***********************************************************************************************************************
+ * @brief Draws the minimap, which shows the whole world, the characters and the viewport.
+ **********************************************************************************************************************/
+void fg_drawMinimap()
+{
+    if (!fg_updateWorldImage() || !fg_updateMinimapAgents())
+        return;
+
+    SDL_FRect l_rect {fg_getMinimapRect()};
+
+    SDL_SetRenderDrawBlendMode(g_renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(g_renderer, 0u, 63u, 0u, 255u);
+    SDL_RenderFillRectF(g_renderer, &l_rect);
+    SDL_RenderCopyF(g_renderer, g_worldImage.f_getTexture(), nullptr, &l_rect);
+    SDL_RenderCopyF(g_renderer, g_minimapAgents.f_getTexture(), nullptr, &l_rect);
+
+    // The viewport's rectangle, cut to the minimap.
+
+    float l_scaleX {l_rect.w / static_cast<float>(g_worldW)};
+    float l_scaleY {l_rect.h / static_cast<float>(g_worldH)};
+    float l_left   {max(l_rect.x + g_viewportX * l_scaleX, l_rect.x)};
+    float l_top    {max(l_rect.y + g_viewportY * l_scaleY, l_rect.y)};
+    float l_right  {min(l_rect.x + (g_viewportX + g_viewportW / g_tileW) * l_scaleX, l_rect.x + l_rect.w)};
+    float l_bottom {min(l_rect.y + (g_viewportY + g_viewportH / g_tileH) * l_scaleY, l_rect.y + l_rect.h)};
+
+    if (l_left >= l_right || l_top >= l_bottom)
+        return;
+
+    SDL_FRect l_viewportRect {l_left, l_top, l_right - l_left, l_bottom - l_top};
+
+    SDL_SetRenderDrawColor(g_renderer, 255u, 255u, 255u, 255u);
+    SDL_RenderDrawRectF(g_renderer, &l_viewportRect);
 }
 
 /***********************************************************************************************************************
@@ -384,12 +1120,58 @@ void fg_drawWorld()
     int l_fromY {static_cast<int>(l_b)};
     int l_toY   {static_cast<int>(ceil(l_b + (l_tileH <= 0.f ? 0.f : l_viewportH / l_tileH)))};
 
-    // Draws the world.
+    // Draws the characters, under the static objects. Only the characters in the grid cells of the visible tiles are
+    // looked at.
 
-    for (int l_y {l_fromY}; l_y != l_toY; ++l_y)
-        for (int l_x {l_fromX}; l_x != l_toX; ++l_x)
-            if (l_x >= 0 && l_y >= 0 && l_x < g_worldW && l_y < g_worldH)
-                fg_drawTile(l_x, l_y, l_viewportX, l_viewportY, l_tileW, l_tileH, l_padX, l_padY);
+    auto fl_drawCharacter = [&](int p_x, int p_y)
+    {
+        SDL_FRect l_renderRect
+        {
+            static_cast<float>(p_x) * l_tileW + l_padX - l_viewportX,
+            static_cast<float>(p_y) * l_tileH + l_padY - l_viewportY,
+            l_tileW,
+            l_tileH
+        };
+
+        SDL_RenderCopyF(g_renderer, g_atlas, &g_sprites[g_playerCharacterSprite].v_rect, &l_renderRect);
+    };
+
+    g_visibleCharacters.clear();
+    c_playerCharacter::fs_findCharactersInRect(l_fromX, l_fromY, l_toX, l_toY, g_visibleCharacters);
+
+    for (const c_playerCharacter *l_character : g_visibleCharacters)
+        fl_drawCharacter(l_character->f_getPos().first, l_character->f_getPos().second);
+
+    g_visibleCrowd.clear();
+    g_crowd.f_findInRect(l_fromX, l_fromY, l_toX, l_toY, g_visibleCrowd);
+
+    for (size_t l_i : g_visibleCrowd)
+        fl_drawCharacter(g_crowd.f_getPos(l_i).first, g_crowd.f_getPos(l_i).second);
+
+    // Draws the world. The chunks of the static objects are drawn over the characters, with their empty tiles
+    // transparent. Zoomed out far enough, a texel per tile is drawn instead, and zoomed in too far for the chunks'
+    // textures, or without render targets, the static objects are batched.
+
+    c_tileBatchView l_view
+    {l_fromX, l_fromY, l_toX, l_toY, l_viewportX, l_viewportY, l_tileW, l_tileH, l_padX, l_padY, fg_getWorldRevision()};
+
+    bool l_canUseChunks
+    {
+        ceil(l_tileW * g_renderChunkSize) <= g_renderChunkMaxTextureSize &&
+        ceil(l_tileH * g_renderChunkSize) <= g_renderChunkMaxTextureSize &&
+        SDL_RenderTargetSupported(g_renderer)
+    };
+
+    if (max(l_tileW, l_tileH) < g_lodTileSize && fg_updateWorldImage())
+    {
+        fg_drawLod(l_view);
+        fg_destroyRenderChunks();
+    }
+    else if (!l_canUseChunks || !fg_drawRenderChunks(l_view))
+    {
+        fg_destroyRenderChunks();
+        fg_drawTileBatch(l_view);
+    }
 
     // Draws the viewport padding.
 
@@ -410,12 +1192,64 @@ void fg_drawWorld()
     SDL_RenderFillRect(g_renderer, &l_padRight);
 }
 
+/***********************************************************************************************************************
+ * @brief Prints the pathfinding statistics to the console every @c g_pfStatsInterval, while they are toggled on.
+ **********************************************************************************************************************/
+void fg_printPfStats()
+{
+    if (!g_arePfStatsPrinted || SDL_GetTicks64() < g_nextPfStatsTime)
+        return;
+
+    g_nextPfStatsTime = SDL_GetTicks64() + g_pfStatsInterval;
+
+    const c_pfSearchStats &l_searchStats {g_playerCharacters.front().f_getPfSearchStats()};
+
+    cout << "The player's latest search expanded "
+         << l_searchStats.v_expandedNodes
+         << " nodes in "
+         << l_searchStats.v_microseconds
+         << " us.\n";
+
+    const c_pfPathCache      &l_cache      {fg_getPfPathCache()};
+    const c_pfPathCacheStats &l_cacheStats {l_cache.f_getStats()};
+
+    cout << "The path cache holds "
+         << l_cache.f_getSize()
+         << " results, with "
+         << l_cacheStats.v_hits
+         << " hits, "
+         << l_cacheStats.v_misses
+         << " misses ("
+         << lround(l_cacheStats.f_getHitRate() * 100.)
+         << "% hit rate) and "
+         << l_cacheStats.v_evictions
+         << " evictions.\n";
+
+    // The landmarks are only built once a character searches with them.
+    if (shared_ptr<const c_pfLandmarks> l_landmarks {fg_getPfLandmarks()})
+    {
+        const c_pfLandmarkStats &l_landmarkStats {l_landmarks->f_getStats()};
+
+        cout << "The "
+             << l_landmarkStats.v_landmarkCount
+             << " landmarks' tables take "
+             << l_landmarkStats.v_memoryBytes / 1024u
+             << " KiB, and were built in "
+             << l_landmarkStats.v_buildMicroseconds
+             << " us at the world's revision "
+             << l_landmarkStats.v_worldRevision
+             << ".\n";
+    }
+}
+
 }
 
 array<array<unsigned char, g_worldH>, g_worldW> g_staticObjs {};
 
 vector<c_playerCharacter> g_playerCharacters {};
 
+c_crowd g_crowd {};
+
 }
 
 
@@ -442,17 +1276,27 @@ int main([[maybe_unused]] int p_argCount, [[maybe_unused]] char *p_args[])
     fg_registerKeybind(ev_moveRight, SDLK_d);
     fg_registerKeybind(ev_moveFaster, SDLK_LSHIFT);
     fg_registerKeybind(ev_setPfGoal, SDLK_SPACE);
+    fg_registerKeybind(ev_toggleCooperative, SDLK_c);
+    fg_registerKeybind(ev_togglePfStats, SDLK_F3);
 
     fg_registerKeybindAxis(ev_moveUpDown,    ev_moveUp,   ev_moveDown);
     fg_registerKeybindAxis(ev_moveLeftRight, ev_moveLeft, ev_moveRight);
 
     fg_registerKeybind(ev_placeWalls, SDLK_1);
     fg_registerKeybind(ev_placeTargets, SDLK_2);
+    fg_registerKeybind(ev_placeCharacters, SDLK_3);
 
-    g_staticObjs[1u][1u] = 0u;
+    fg_setStaticObj(1, 1, 0u);
     g_playerCharacters.push_back({1, 1});
+    g_playerCharacters.front().f_setPfReplanMode(c_playerCharacter::e_pfReplanMode::ev_repair);
+    g_playerCharacters.front().f_setPfAlgorithm(e_pfAlgorithm::ev_hierarchical);
+    g_playerCharacters.front().f_setPfAsync(true);
     size_t l_playerGoalX {1u};
     size_t l_playerGoalY {1u};
+    size_t l_crowdGoalX  {1u};
+    size_t l_crowdGoalY  {1u};
+
+    vector<size_t> l_crowdOnTile {};
 
     while (fg_handleInputEvents())
     {
@@ -462,6 +1306,7 @@ int main([[maybe_unused]] int p_argCount, [[maybe_unused]] char *p_args[])
         SDL_RenderClear(g_renderer);
 
         fg_drawWorld();
+        fg_drawMinimap();
 
         // Viewport movement.
         {
@@ -479,36 +1324,60 @@ int main([[maybe_unused]] int p_argCount, [[maybe_unused]] char *p_args[])
                 g_currentPlacementMode = e_placementMode::ev_walls;
             else if (fg_wasKeybindPressed(ev_placeTargets))
                 g_currentPlacementMode = e_placementMode::ev_targets;
+            else if (fg_wasKeybindPressed(ev_placeCharacters))
+                g_currentPlacementMode = e_placementMode::ev_characters;
 
             auto [l_pointerPosX, l_pointerPosY] {fg_getWorldSpacePos(fg_getPointerX(), fg_getPointerY())};
+            auto l_minimapPos                   {fg_getMinimapWorldPos(fg_getPointerX(), fg_getPointerY())};
 
-            if (fg_isPosInWorldBounds(l_pointerPosX, l_pointerPosY))
+            // The pointer recenters the viewport on the minimap, instead of placing objects under it.
+            if (l_minimapPos)
+            {
+                if (fg_isPointerPrimaryDown())
+                    fg_centerViewport(l_minimapPos->first, l_minimapPos->second);
+            }
+            else if (fg_isPosInWorldBounds(l_pointerPosX, l_pointerPosY))
             {
-                size_t l_tileX {static_cast<size_t>(l_pointerPosX)};
-                size_t l_tileY {static_cast<size_t>(l_pointerPosY)};
+                int l_tileX {static_cast<int>(l_pointerPosX)};
+                int l_tileY {static_cast<int>(l_pointerPosY)};
 
                 if (fg_isPointerPrimaryDown())
                 {
                     switch (g_currentPlacementMode)
                     {
                         case e_placementMode::ev_walls:
-                            g_staticObjs[l_tileX][l_tileY] = 1u;
+                            fg_setStaticObj(l_tileX, l_tileY, 1u);
                             break;
 
                         case e_placementMode::ev_targets:
-                            g_staticObjs[l_tileX][l_tileY] = 2u;
+                            fg_setStaticObj(l_tileX, l_tileY, 2u);
+                            break;
+
+                        // A character is added to the free tile under the pointer, heading to the player's goal. A
+                        // tile that already has one is skipped, so that holding the pointer still doesn't stack them.
+                        case e_placementMode::ev_characters:
+                            l_crowdOnTile.clear();
+                            g_crowd.f_findInRect(l_tileX, l_tileY, l_tileX + 1, l_tileY + 1, l_crowdOnTile);
+
+                            if (g_staticObjs[l_tileX][l_tileY] == 0u && l_crowdOnTile.empty())
+                            {
+                                int l_goalX {static_cast<int>(l_playerGoalX)};
+                                int l_goalY {static_cast<int>(l_playerGoalY)};
+                                g_crowd.f_add(l_tileX, l_tileY, l_goalX, l_goalY, 4.f);
+                            }
                     }
                 }
                 else if (fg_isPointerSecondaryDown())
                 {
-                    g_staticObjs[l_tileX][l_tileY] = 0u;
+                    fg_setStaticObj(l_tileX, l_tileY, 0u);
                 }
             }
         }
 
         // The player character's movement.
         {
-            if (fg_isKeybindDown(ev_setPfGoal))
+            // Like the placement, the goal isn't set to the tile hidden under the minimap.
+            if (fg_isKeybindDown(ev_setPfGoal) && !fg_getMinimapWorldPos(fg_getPointerX(), fg_getPointerY()))
             {
                 auto [l_pointerPosX, l_pointerPosY] {fg_getWorldSpacePos(fg_getPointerX(), fg_getPointerY())};
 
@@ -519,7 +1388,51 @@ int main([[maybe_unused]] int p_argCount, [[maybe_unused]] char *p_args[])
                 }
             }
 
-            g_playerCharacters.front().f_pfMoveTowardsGoal(l_playerGoalX, l_playerGoalY);
+            // The player character switches between repairing its path and planning cooperatively with the others.
+            if (fg_wasKeybindPressed(ev_toggleCooperative))
+            {
+                using e_mode = c_playerCharacter::e_pfReplanMode;
+
+                c_playerCharacter &l_character {g_playerCharacters.front()};
+                bool l_isCooperative {l_character.f_getPfReplanMode() == e_mode::ev_cooperative};
+                l_character.f_setPfReplanMode(l_isCooperative ? e_mode::ev_repair : e_mode::ev_cooperative);
+            }
+
+            // The paths that the tick's edits may have broken are checked at once, before anyone moves.
+            c_playerCharacter::fs_pfCheckEditedPaths();
+
+            g_playerCharacters.front().f_setGoal(static_cast<int>(l_playerGoalX), static_cast<int>(l_playerGoalY));
+            c_playerCharacter::fs_moveScheduledCharacters();
+            c_playerCharacter::fs_pfMoveCooperatively();
+
+            // The sliced searches share a node budget per tick, so that a large search doesn't stall the tick.
+            c_playerCharacter::fs_pfResumeSlicedSearches(g_pfSlicedNodeBudget);
+        }
+
+        // The crowd's movement. The crowd follows the player character's goal, and is only sent to it when it changes.
+        // The characters that are added in between head to the same goal already.
+        {
+            if (l_playerGoalX != l_crowdGoalX || l_playerGoalY != l_crowdGoalY)
+            {
+                l_crowdGoalX = l_playerGoalX;
+                l_crowdGoalY = l_playerGoalY;
+
+                for (size_t l_i {}; l_i != g_crowd.f_getSize(); ++l_i)
+                    g_crowd.f_setGoal(l_i, static_cast<int>(l_crowdGoalX), static_cast<int>(l_crowdGoalY));
+            }
+
+            g_crowd.f_update(fg_getSimTime());
+        }
+
+        // The pathfinding statistics are printed at once when toggled on, and then at intervals.
+        {
+            if (fg_wasKeybindPressed(ev_togglePfStats))
+            {
+                g_arePfStatsPrinted = !g_arePfStatsPrinted;
+                g_nextPfStatsTime = 0u;
+            }
+
+            fg_printPfStats();
         }
 
         SDL_RenderPresent(g_renderer);
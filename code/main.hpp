@@ -23,6 +23,10 @@ class c_playerCharacter;
 
 extern std::vector<c_playerCharacter> g_playerCharacters;
 
+class c_crowd;
+
+extern c_crowd g_crowd; //!< The simulated characters which aren't controlled by the player.
+
 /***********************************************************************************************************************
  * @brief Checks whether a world-space position is inside the world's boundaries.
  * @param p_x, p_y The world-space position.
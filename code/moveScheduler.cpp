@@ -0,0 +1,139 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of @c c_moveScheduler.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "moveScheduler.hpp"
+
+    #include <algorithm>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+// Private members.
+#if 1
+
+    void c_moveScheduler::f_place(const c_entry &p_entry)
+    {
+        if (p_entry.v_time >> fs_slotBits == v_time >> fs_slotBits)
+        {
+            v_nearSlots[p_entry.v_time & fs_slotMask].push_back(p_entry);
+            ++v_nearCount;
+        }
+        else if (p_entry.v_time >> fs_slotBits * 2 == v_time >> fs_slotBits * 2)
+        {
+            v_farSlots[p_entry.v_time >> fs_slotBits & fs_slotMask].push_back(p_entry);
+            ++v_farCount;
+        }
+        else
+            v_laterSlot.push_back(p_entry);
+    }
+
+#endif
+
+// Public members.
+#if 1
+
+    void c_moveScheduler::f_schedule(uint32_t p_agent, uint64_t p_time)
+    {
+        if (p_agent >= v_agentTimes.size())
+            v_agentTimes.resize(static_cast<size_t>(p_agent) + 1u, g_moveSchedulerNoTime);
+
+        p_time = max(p_time, v_time);
+
+        if (v_agentTimes[p_agent] == p_time)
+            return;
+
+        v_agentTimes[p_agent] = p_time;
+        f_place({p_agent, p_time});
+    }
+
+    void c_moveScheduler::f_cancel(uint32_t p_agent)
+    {
+        if (p_agent < v_agentTimes.size())
+            v_agentTimes[p_agent] = g_moveSchedulerNoTime;
+    }
+
+    uint64_t c_moveScheduler::f_getTime(uint32_t p_agent) const
+    {
+        return p_agent < v_agentTimes.size() ? v_agentTimes[p_agent] : g_moveSchedulerNoTime;
+    }
+
+    void c_moveScheduler::f_advanceTo(uint64_t p_time, vector<uint32_t> &p_agents)
+    {
+        while (v_time <= p_time)
+        {
+            vector<c_entry> &l_slot {v_nearSlots[v_time & fs_slotMask]};
+
+            for (const c_entry &l_entry : l_slot)
+            {
+                if (v_agentTimes[l_entry.v_agent] != l_entry.v_time)
+                    continue; // The agent has been scheduled again or cancelled since.
+
+                v_agentTimes[l_entry.v_agent] = g_moveSchedulerNoTime;
+                p_agents.push_back(l_entry.v_agent);
+            }
+
+            v_nearCount -= l_slot.size();
+            l_slot.clear();
+
+            // The rest of an empty wheel is skipped at once, but not past the time, which could be scheduled still.
+            if (v_nearCount == 0u)
+                v_time = min((v_time | fs_slotMask) + 1u, p_time + 1u);
+            else
+                ++v_time;
+
+            if ((v_time & fs_slotMask) != 0u)
+                continue;
+
+            if ((v_time >> fs_slotBits & fs_slotMask) == 0u)
+            {
+                // Like the first wheel, an empty second wheel is skipped, up to the time of the earliest later entry.
+                if (v_farCount == 0u)
+                {
+                    uint64_t l_laterTime {g_moveSchedulerNoTime};
+
+                    for (const c_entry &l_entry : v_laterSlot)
+                    {
+                        if (v_agentTimes[l_entry.v_agent] == l_entry.v_time)
+                            l_laterTime = min(l_laterTime, l_entry.v_time);
+                    }
+
+                    v_time = max(v_time, min(l_laterTime, p_time + 1u) & ~fs_slotMask);
+                }
+
+                vector<c_entry> l_laterSlot {};
+                swap(l_laterSlot, v_laterSlot);
+
+                for (const c_entry &l_entry : l_laterSlot)
+                {
+                    if (v_agentTimes[l_entry.v_agent] == l_entry.v_time)
+                        f_place(l_entry);
+                }
+            }
+
+            vector<c_entry> &l_farSlot {v_farSlots[v_time >> fs_slotBits & fs_slotMask]};
+            v_farCount -= l_farSlot.size();
+
+            for (const c_entry &l_entry : l_farSlot)
+            {
+                if (v_agentTimes[l_entry.v_agent] == l_entry.v_time)
+                    f_place(l_entry);
+            }
+
+            l_farSlot.clear();
+        }
+    }
+
+#endif
+
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The header file of @c c_moveScheduler.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+constexpr uint64_t g_moveSchedulerNoTime {UINT64_MAX}; //!< The time of an agent which isn't scheduled.
+
+/***********************************************************************************************************************
+ * @brief A hierarchical timing wheel, which wakes the agents whose moves are due, without looking at the others.
+ * @details The time is in milliseconds. The first wheel has a slot for every millisecond of the current 256, and the
+ * second one has a slot for every 256 milliseconds of the current 65536. The later times are kept in a list. When the
+ * time reaches the start of a slot of the second wheel, the slot is spread into the first wheel, and when it reaches
+ * the start of the second wheel, the list is spread into it. So scheduling is constant-time, and every agent is
+ * touched at most three times before it's woken.
+ *
+ * An agent has at most one time. Scheduling it again or cancelling it leaves its old entry in its slot, where it's
+ * skipped when the slot is reached.
+ **********************************************************************************************************************/
+class c_moveScheduler
+{
+    private:
+
+    static constexpr int      fs_slotBits  {8};                 //!< The number of bits of a wheel's slot index.
+    static constexpr size_t   fs_slotCount {1u << fs_slotBits}; //!< The number of slots in a wheel.
+    static constexpr uint64_t fs_slotMask  {fs_slotCount - 1u}; //!< Masks a slot index out of a time.
+
+    /*******************************************************************************************************************
+     * @brief An agent's entry in a slot.
+     ******************************************************************************************************************/
+    class c_entry
+    {
+        public:
+
+        uint32_t v_agent {}; //!< The agent.
+        uint64_t v_time  {}; //!< The time when the agent is due. The entry is stale if the agent's time is another.
+    };
+
+    std::array<std::vector<c_entry>, fs_slotCount> v_nearSlots   {}; //!< The first wheel, a slot per millisecond.
+    std::array<std::vector<c_entry>, fs_slotCount> v_farSlots    {}; //!< The second wheel, a slot per 256 ms.
+    std::vector<c_entry>                           v_laterSlot   {}; //!< The entries beyond the second wheel.
+    size_t                                         v_nearCount   {}; //!< The number of entries in the first wheel.
+    size_t                                         v_farCount    {}; //!< The number of entries in the second wheel.
+    std::vector<uint64_t>                          v_agentTimes  {}; //!< The time of every agent, by agent.
+    uint64_t                                       v_time        {}; //!< The earliest time that hasn't been woken.
+
+    /*******************************************************************************************************************
+     * @brief Puts an entry in the wheel or the list which covers its time.
+     * @param p_entry The entry. Its time must not be earlier than @c v_time.
+     ******************************************************************************************************************/
+    void f_place(const c_entry &p_entry);
+
+    public:
+
+    /*******************************************************************************************************************
+     * @brief Schedules an agent, replacing its earlier time.
+     * @param p_agent The agent.
+     * @param p_time The time when the agent is due. A time that has already been woken is woken on the next advance.
+     ******************************************************************************************************************/
+    void f_schedule(uint32_t p_agent, uint64_t p_time);
+
+    /*******************************************************************************************************************
+     * @brief Removes an agent's time, if it has one.
+     * @param p_agent The agent.
+     ******************************************************************************************************************/
+    void f_cancel(uint32_t p_agent);
+
+    /*******************************************************************************************************************
+     * @param p_agent An agent.
+     * @return The time when the agent is due. @c g_moveSchedulerNoTime if it isn't scheduled.
+     ******************************************************************************************************************/
+    uint64_t f_getTime(uint32_t p_agent) const;
+
+    /*******************************************************************************************************************
+     * @brief Wakes the agents which are due by a time, and removes their times.
+     * @param p_time The time. The empty stretches of the wheels are skipped, so a long jump is cheap.
+     * @param p_agents Gets the woken agents added to it, in the order of their times.
+     ******************************************************************************************************************/
+    void f_advanceTo(uint64_t p_time, std::vector<uint32_t> &p_agents);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,389 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The bit-parallel wavefront, which spreads 64 tiles of a column at a time.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfBitWavefront.hpp"
+
+    #include <algorithm>
+    #include <array>
+    #include <bit>
+    #include <vector>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+constexpr int    g_pfHealthBitCount {4}; //!< The number of bits that a health takes.
+constexpr size_t g_pfBitWordCount   {static_cast<size_t>(g_worldW) * g_worldBitWordsH}; //!< The world's words.
+
+static_assert(g_pfNodeMaxHealth < 1 << g_pfHealthBitCount);
+
+/***********************************************************************************************************************
+ * @brief A word of a wavefront's tiles, which is a part of a column as in @c t_worldTileBits. The tiles' healths are
+ * bit-sliced, so that a tile's health can be spread along with the tile.
+ **********************************************************************************************************************/
+class c_pfBitWaveWord
+{
+    public:
+
+    uint32_t                            v_index      {}; //!< The word's index, as in @c fg_getBitWordIndex.
+    uint64_t                            v_tiles      {}; //!< The tiles.
+    array<uint64_t, g_pfHealthBitCount> v_healthBits {}; //!< The bits of the tiles' healths, lowest first.
+
+    /*******************************************************************************************************************
+     * @param p_bit The tile's bit.
+     * @return The tile's health. 0 if the tile isn't in the wavefront.
+     ******************************************************************************************************************/
+    int f_getHealth(int p_bit) const
+    {
+        int l_health {};
+
+        for (size_t l_i {}; l_i != v_healthBits.size(); ++l_i)
+            l_health |= static_cast<int>(v_healthBits[l_i] >> p_bit & 1u) << l_i;
+
+        return l_health;
+    }
+};
+
+// The memory is per thread, so that searches of snapshots can run on several threads at once. It's kept between
+// searches, so that a search only allocates when it goes further than the earlier ones.
+
+//! The wavefront of every step, as the words that have tiles, ordered by their index. The path is recovered from
+//! these after the goal has been found.
+thread_local vector<c_pfBitWaveWord> g_pfBitWaveWords {};
+
+//! The index of every step's first word in @c g_pfBitWaveWords, and the index past the last step's words.
+thread_local vector<size_t> g_pfBitWaveSteps {};
+
+//! The words of the step which is being spread, by their indices. They're offset by a column, so that the columns
+//! next to the world's edges can be read as empty. Left as all empty between the steps.
+thread_local array<c_pfBitWaveWord, g_pfBitWordCount + 2u * g_worldBitWordsH> g_pfBitWaveStepWords {};
+
+//! The words which the step which is being spread may reach. Left as all 0 between the steps.
+thread_local array<uint64_t, g_pfBitWordCount / 64u> g_pfBitWaveTargets {};
+
+thread_local t_worldTileBits g_pfBitSpreadTiles {}; //!< The tiles that have been in the wavefront.
+
+/***********************************************************************************************************************
+ * @param p_x, p_y A world-space tile position inside the world's boundaries.
+ * @return The index of the word that has the tile. The words of a column are consecutive.
+ **********************************************************************************************************************/
+uint32_t fg_getBitWordIndex(int p_x, int p_y)
+{
+    return static_cast<uint32_t>(p_x * g_worldBitWordsH + p_y / 64);
+}
+
+/***********************************************************************************************************************
+ * @brief Finds a word of a step's wavefront.
+ * @param p_step The step.
+ * @param p_x, p_y A world-space tile position of the word, which may be outside the world's boundaries.
+ * @return The word, or null if the step's wavefront has no tiles in it.
+ **********************************************************************************************************************/
+const c_pfBitWaveWord *fg_findBitWaveWord(size_t p_step, int p_x, int p_y)
+{
+    if (!fg_isPosInWorldBounds(p_x, p_y))
+        return nullptr;
+
+    uint32_t l_index {fg_getBitWordIndex(p_x, p_y)};
+    auto     l_begin {g_pfBitWaveWords.begin() + static_cast<ptrdiff_t>(g_pfBitWaveSteps[p_step])};
+    auto     l_end   {g_pfBitWaveWords.begin() + static_cast<ptrdiff_t>(g_pfBitWaveSteps[p_step + 1u])};
+    auto     l_it
+    {
+        lower_bound
+        (l_begin, l_end, l_index, [](const c_pfBitWaveWord &p_word, uint32_t p_i) {return p_word.v_index < p_i;})
+    };
+
+    return l_it != l_end && l_it->v_index == l_index ? &*l_it : nullptr;
+}
+
+/***********************************************************************************************************************
+ * @param p_world The world which is searched.
+ * @param p_index A word's index.
+ * @return The free tiles of the word which haven't been in the wavefront.
+ **********************************************************************************************************************/
+uint64_t fg_getUnreachedBits(const c_worldView &p_world, uint32_t p_index)
+{
+    size_t l_x            {p_index / g_worldBitWordsH};
+    size_t l_wordInColumn {p_index % g_worldBitWordsH};
+
+    return p_world.f_getFreeTileBits()[l_x][l_wordInColumn] & ~g_pfBitSpreadTiles[l_x][l_wordInColumn];
+}
+
+/***********************************************************************************************************************
+ * @brief Marks the words that a word of the wavefront spreads to. Only the words with tiles that it reaches are
+ * marked, since in narrow corridors most of the neighbouring words are walls or have been spread to already.
+ * @param p_world The world which is searched.
+ * @param p_word The word.
+ **********************************************************************************************************************/
+void fg_markBitWaveTargets(const c_worldView &p_world, const c_pfBitWaveWord &p_word)
+{
+    auto fl_mark = [&](uint32_t p_index, uint64_t p_fromTiles)
+    {
+        if ((p_fromTiles & fg_getUnreachedBits(p_world, p_index)) != 0u)
+            g_pfBitWaveTargets[p_index / 64u] |= uint64_t {1u} << (p_index % 64u);
+    };
+
+    uint32_t l_wordInColumn {p_word.v_index % g_worldBitWordsH};
+
+    fl_mark(p_word.v_index, p_word.v_tiles << 1u | p_word.v_tiles >> 1u);
+
+    if (p_word.v_index >= g_worldBitWordsH)
+        fl_mark(p_word.v_index - g_worldBitWordsH, p_word.v_tiles);
+
+    if (p_word.v_index + g_worldBitWordsH < g_pfBitWordCount)
+        fl_mark(p_word.v_index + g_worldBitWordsH, p_word.v_tiles);
+
+    // A tile at either end of the word reaches into the neighbouring word of the column.
+    if (l_wordInColumn != 0u)
+        fl_mark(p_word.v_index - 1u, p_word.v_tiles << 63u);
+
+    if (l_wordInColumn + 1u != g_worldBitWordsH)
+        fl_mark(p_word.v_index + 1u, p_word.v_tiles >> 63u);
+}
+
+/***********************************************************************************************************************
+ * @brief Spreads the wavefront of the step which is being spread to a word.
+ * @param p_index The index of the word which is spread to.
+ * @param p_world The world which is searched.
+ * @param p_word Gets the tiles which were reached, including the ones with 0 health, and their healths.
+ * @return True if any tiles were reached.
+ **********************************************************************************************************************/
+bool fg_spreadBitWaveToWord(uint32_t p_index, const c_worldView &p_world, c_pfBitWaveWord &p_word)
+{
+    static const c_pfBitWaveWord s_emptyWord {};
+
+    size_t   l_x            {p_index / g_worldBitWordsH};
+    size_t   l_wordInColumn {p_index % g_worldBitWordsH};
+    uint64_t l_nearWall     {p_world.f_getNearWallTileBits()[l_x][l_wordInColumn]};
+    uint64_t l_unreached    {fg_getUnreachedBits(p_world, p_index)};
+
+    // The wavefront's words from which this word may be reached.
+    const c_pfBitWaveWord *l_sameWord  {&g_pfBitWaveStepWords[p_index + g_worldBitWordsH]};
+    const c_pfBitWaveWord &l_leftWord  {l_sameWord[-g_worldBitWordsH]};
+    const c_pfBitWaveWord &l_rightWord {l_sameWord[g_worldBitWordsH]};
+    const c_pfBitWaveWord &l_upWord    {l_wordInColumn != 0u ? l_sameWord[-1] : s_emptyWord};
+    const c_pfBitWaveWord &l_downWord  {l_wordInColumn + 1u != g_worldBitWordsH ? l_sameWord[1] : s_emptyWord};
+
+    p_word = {};
+    p_word.v_index = p_index;
+
+    uint64_t l_reachedTiles
+    {
+        (
+            l_leftWord.v_tiles | l_rightWord.v_tiles | l_sameWord->v_tiles << 1u | l_upWord.v_tiles >> 63u |
+            l_sameWord->v_tiles >> 1u | l_downWord.v_tiles << 63u
+        ) &
+        l_unreached
+    };
+
+    if (l_reachedTiles == 0u)
+        return false;
+
+    // The tiles near walls get the maximum health from any direction, so if every reached tile is near a wall, which
+    // is common in narrow corridors, the healths aren't spread.
+    if ((l_reachedTiles & ~l_nearWall) == 0u)
+    {
+        p_word.v_tiles = l_reachedTiles;
+
+        for (size_t l_bit {}; l_bit != p_word.v_healthBits.size(); ++l_bit)
+            if ((g_pfNodeMaxHealth >> l_bit & 1) != 0)
+                p_word.v_healthBits[l_bit] = l_reachedTiles;
+
+        return true;
+    }
+
+    // Like in the original wavefront, a tile which is reached from several tiles takes the health of the first one,
+    // in the order right, down, left and up. A tile's Y-position grows with its bit, and carries over from the
+    // neighbouring word.
+
+    uint64_t l_rightTiles {l_leftWord.v_tiles & l_reachedTiles};
+    uint64_t l_downTiles  {(l_sameWord->v_tiles << 1u | l_upWord.v_tiles >> 63u) & l_reachedTiles & ~l_rightTiles};
+    uint64_t l_leftTiles  {l_rightWord.v_tiles & l_reachedTiles & ~(l_rightTiles | l_downTiles)};
+    uint64_t l_upTiles    {l_reachedTiles & ~(l_rightTiles | l_downTiles | l_leftTiles)};
+
+    p_word.v_tiles = l_reachedTiles;
+
+    for (size_t l_bit {}; l_bit != p_word.v_healthBits.size(); ++l_bit)
+    {
+        p_word.v_healthBits[l_bit] =
+        (l_leftWord.v_healthBits[l_bit] & l_rightTiles) |
+        ((l_sameWord->v_healthBits[l_bit] << 1u | l_upWord.v_healthBits[l_bit] >> 63u) & l_downTiles) |
+        (l_rightWord.v_healthBits[l_bit] & l_leftTiles) |
+        ((l_sameWord->v_healthBits[l_bit] >> 1u | l_downWord.v_healthBits[l_bit] << 63u) & l_upTiles);
+    }
+
+    // Subtracts 1 from the healths of the tiles that aren't near a wall, and gives the others the maximum health. The
+    // wavefront's tiles have at least 1 health, so the subtraction never borrows past the highest bit.
+    uint64_t l_borrow {~l_nearWall};
+
+    l_nearWall &= p_word.v_tiles;
+
+    for (size_t l_bit {}; l_bit != p_word.v_healthBits.size(); ++l_bit)
+    {
+        uint64_t &l_healthBits {p_word.v_healthBits[l_bit]};
+        uint64_t  l_oldBits    {l_healthBits};
+        l_healthBits = (l_oldBits ^ l_borrow) & p_word.v_tiles;
+        l_borrow &= ~l_oldBits;
+
+        if ((g_pfNodeMaxHealth >> l_bit & 1) != 0)
+            l_healthBits |= l_nearWall;
+        else
+            l_healthBits &= ~l_nearWall;
+    }
+
+    return true;
+}
+
+}
+
+bool fg_pfSearchBitWavefront(const c_worldView &p_world, int p_fromX, int p_fromY, int p_goalX, int p_goalY,
+c_pfNodeGrid &p_pfNodes, c_pfSearchStats &p_stats)
+{
+    using enum e_pfNodeDir;
+
+    // A goal with a static object would be searched for until the whole reachable world is flooded.
+    if (fg_isPosInWorldBounds(p_goalX, p_goalY) && !p_world.f_isFree(p_goalX, p_goalY))
+        return false;
+
+    c_pfNode &l_startNode {p_pfNodes.f_visit(p_fromX, p_fromY)};
+    l_startNode.v_health = static_cast<unsigned char>(g_pfNodeMaxHealth);
+
+    if (p_fromX == p_goalX && p_fromY == p_goalY)
+        return true;
+
+    c_pfBitWaveWord l_startWord {};
+    l_startWord.v_index = fg_getBitWordIndex(p_fromX, p_fromY);
+    l_startWord.v_tiles = uint64_t {1u} << (p_fromY % 64);
+
+    for (size_t l_bit {}; l_bit != l_startWord.v_healthBits.size(); ++l_bit)
+        if ((g_pfNodeMaxHealth >> l_bit & 1) != 0)
+            l_startWord.v_healthBits[l_bit] = l_startWord.v_tiles;
+
+    g_pfBitWaveWords.assign(1u, l_startWord);
+    g_pfBitWaveSteps.assign({0u, 1u});
+    g_pfBitSpreadTiles = {};
+    g_pfBitSpreadTiles[static_cast<size_t>(p_fromX)][static_cast<size_t>(p_fromY / 64)] = l_startWord.v_tiles;
+
+    bool            l_hasGoal   {fg_isPosInWorldBounds(p_goalX, p_goalY)};
+    uint32_t        l_goalIndex {l_hasGoal ? fg_getBitWordIndex(p_goalX, p_goalY) : 0u};
+    c_pfBitWaveWord l_word      {};
+    size_t          l_step      {};
+    bool            l_isFound   {};
+
+    while (!l_isFound && g_pfBitWaveSteps[l_step] != g_pfBitWaveSteps[l_step + 1u])
+    {
+        size_t l_stepBegin {g_pfBitWaveSteps[l_step]};
+        size_t l_stepEnd   {g_pfBitWaveSteps[l_step + 1u]};
+
+        for (size_t l_position {l_stepBegin}; l_position != l_stepEnd; ++l_position)
+        {
+            const c_pfBitWaveWord &l_fromWord {g_pfBitWaveWords[l_position]};
+
+            g_pfBitWaveStepWords[l_fromWord.v_index + g_worldBitWordsH] = l_fromWord;
+            fg_markBitWaveTargets(p_world, l_fromWord);
+            p_stats.v_expandedNodes += static_cast<size_t>(popcount(l_fromWord.v_tiles));
+        }
+
+        // The words are spread to in order, so that the next step's words stay ordered. The step's words are ordered
+        // too, so the targets are at most a column away from the first and the last one.
+
+        size_t l_firstTarget {g_pfBitWaveWords[l_stepBegin].v_index};
+        size_t l_lastTarget  {g_pfBitWaveWords[l_stepEnd - 1u].v_index + g_worldBitWordsH};
+        l_firstTarget = l_firstTarget >= g_worldBitWordsH ? l_firstTarget - g_worldBitWordsH : 0u;
+        l_lastTarget = min(l_lastTarget, g_pfBitWordCount - 1u);
+
+        for (size_t l_i {l_firstTarget / 64u}; l_i <= l_lastTarget / 64u; ++l_i)
+        {
+            for (uint64_t l_targets {g_pfBitWaveTargets[l_i]}; l_targets != 0u; l_targets &= l_targets - 1u)
+            {
+                uint32_t l_index {static_cast<uint32_t>(l_i * 64u) + static_cast<uint32_t>(countr_zero(l_targets))};
+
+                if (l_isFound || !fg_spreadBitWaveToWord(l_index, p_world, l_word))
+                    continue;
+
+                if (l_hasGoal && l_index == l_goalIndex && (l_word.v_tiles >> (p_goalY % 64) & 1u) != 0u)
+                    l_isFound = true;
+
+                // The tiles with 0 health aren't spread further, so they may still be reached with more health later.
+                uint64_t l_healthy {};
+
+                for (uint64_t l_healthBits : l_word.v_healthBits)
+                    l_healthy |= l_healthBits;
+
+                l_word.v_tiles &= l_healthy;
+                g_pfBitSpreadTiles[l_index / g_worldBitWordsH][l_index % g_worldBitWordsH] |= l_healthy;
+
+                if (l_healthy != 0u)
+                    g_pfBitWaveWords.push_back(l_word);
+            }
+
+            g_pfBitWaveTargets[l_i] = 0u;
+        }
+
+        for (size_t l_position {l_stepBegin}; l_position != l_stepEnd; ++l_position)
+            g_pfBitWaveStepWords[g_pfBitWaveWords[l_position].v_index + g_worldBitWordsH] = {};
+
+        g_pfBitWaveSteps.push_back(g_pfBitWaveWords.size());
+        ++l_step;
+    }
+
+    if (!l_isFound)
+        return false;
+
+    // Backtracks from the goal through the wavefronts of the earlier steps. A tile's predecessor must have had the
+    // health that the tile got from it, so that the rest of the path stays valid.
+    int l_x {p_goalX};
+    int l_y {p_goalY};
+
+    for (size_t l_prevStep {l_step - 1u}; l_x != p_fromX || l_y != p_fromY; --l_prevStep)
+    {
+        bool l_isGoal {l_x == p_goalX && l_y == p_goalY};
+        int  l_health {};
+
+        if (!l_isGoal)
+            l_health = fg_findBitWaveWord(l_prevStep + 1u, l_x, l_y)->f_getHealth(l_y % 64);
+
+        for (e_pfNodeDir l_dir : {ev_right, ev_down, ev_left, ev_up})
+        {
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dir)};
+            int                    l_prevX    {l_x + l_offsetX};
+            int                    l_prevY    {l_y + l_offsetY};
+            const c_pfBitWaveWord *l_prevWord {fg_findBitWaveWord(l_prevStep, l_prevX, l_prevY)};
+
+            if (l_prevWord == nullptr || (l_prevWord->v_tiles >> (l_prevY % 64) & 1u) == 0u)
+                continue;
+
+            if
+            (
+                !l_isGoal && !p_world.f_isPosNearWall(l_x, l_y) &&
+                l_prevWord->f_getHealth(l_prevY % 64) != l_health + 1
+            )
+            {
+                continue;
+            }
+
+            c_pfNode &l_node {p_pfNodes.f_visit(l_x, l_y)};
+            l_node.v_health = static_cast<unsigned char>(l_health);
+            l_node.v_dir = l_dir;
+            l_x = l_prevX;
+            l_y = l_prevY;
+            break;
+        }
+    }
+
+    return true;
+}
+
+}
\ No newline at end of file
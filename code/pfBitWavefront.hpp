@@ -0,0 +1,44 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The bit-parallel wavefront, which spreads 64 tiles of a column at a time.
+ * @details The wavefront is kept as 64-bit words of tiles, like in @c t_worldTileBits, and the tiles' healths as 4
+ * more words whose bits are the bits of the healths. A step spreads the wavefront a word at a time with shifts, which
+ * are masked with the free tiles and the tiles that haven't been spread to yet. The health of every tile of a word
+ * is lowered or reset with a few more bitwise operations, so no tile is handled on its own.
+ *
+ * The wavefront of every step is kept, and the path is recovered from them by backtracking from the goal. Only the
+ * nodes along the path are written, which is where most of the original wavefront's time per tile goes.
+ *
+ * The search is fastest when the wavefront is wide, such as in open areas where many tiles of the same word are
+ * reached together. In narrow corridors most words have a single tile near a wall. Only the words with reached tiles
+ * are spread to, and the healths aren't spread to words whose reached tiles are all near walls, so the search is
+ * about as fast as the original wavefront on short paths there and faster on long ones.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "pfNodeGrid.hpp"
+#include "pfSearch.hpp"
+#include "world.hpp"
+
+
+
+
+namespace n_tdg
+{
+
+/***********************************************************************************************************************
+ * @brief Searches for a path with the bit-parallel wavefront. The path can be backtracked from the goal by following
+ * the nodes' directions until the start.
+ * @param p_world The world which is searched.
+ * @param p_fromX, p_fromY The start's world-space tile position.
+ * @param p_goalX, p_goalY The goal's world-space tile position. Can be outside the world's boundaries, in which case
+ * the wavefront floods everything that is reachable, but no nodes are written.
+ * @param p_pfNodes The nodes of the search, in which a search has been begun. Only the nodes along the path are set.
+ * @param p_stats Gets the number of spread tiles added to it.
+ * @return True if the goal was found.
+ **********************************************************************************************************************/
+bool fg_pfSearchBitWavefront(const c_worldView &p_world, int p_fromX, int p_fromY, int p_goalX, int p_goalY,
+c_pfNodeGrid &p_pfNodes, c_pfSearchStats &p_stats);
+
+}
\ No newline at end of file
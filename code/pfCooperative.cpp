@@ -0,0 +1,298 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of the cooperative pathfinding.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfCooperative.hpp"
+
+    #include <algorithm>
+    #include <array>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+constexpr size_t        g_pfCooperativeLayerSize {static_cast<size_t>(g_worldW) * static_cast<size_t>(g_worldH)};
+constexpr unsigned char g_pfCooperativeWait      {4u}; //!< The action of a node that was waited on, after the moves.
+
+/***********************************************************************************************************************
+ * @brief A node of the cooperative search, which is a tile at a step of the window. Like @c c_pfNode, it's kept at 4
+ * bytes, since there is a world's worth of them for every step.
+ **********************************************************************************************************************/
+class c_pfCooperativeNode
+{
+    public:
+
+    uint16_t      v_searchId {}; //!< The search which last visited the node.
+    unsigned char v_health   {}; //!< The highest health that the tile has been reached with at the step.
+    unsigned char v_action   {}; //!< The direction of the move to the node, or @c g_pfCooperativeWait.
+};
+
+/***********************************************************************************************************************
+ * @brief An entry of the cooperative search's open list.
+ **********************************************************************************************************************/
+class c_pfCooperativeEntry
+{
+    public:
+
+    uint32_t      v_tile   {}; //!< The index of the node's tile, as in @c c_pfNodeGrid::fs_getIndex.
+    unsigned char v_step   {}; //!< The node's step, counted from the start of the window.
+    unsigned char v_health {}; //!< The node's health when it was pushed. The node is skipped if it has changed.
+};
+
+//! The nodes of the cooperative search, a world-sized layer for every step of the window.
+vector<c_pfCooperativeNode> g_pfCooperativeNodes    {};
+uint16_t                    g_pfCooperativeSearchId {}; //!< The ID of the current cooperative search.
+
+//! The cooperative search's open list, bucketed by the estimate minus the start's. A wait raises the estimate by 1, and
+//! so does a step away from the goal in an open area, so a plan that avoids the others mostly stays within twice the
+//! window. The nodes beyond that share the last bucket, which only loosens the order of the nodes far off the plan.
+array<vector<c_pfCooperativeEntry>, g_pfCooperativeWindow * 2 + 1> g_pfCooperativeBuckets {};
+
+/***********************************************************************************************************************
+ * @param p_step A step, counted from the start of the window.
+ * @param p_tile The index of a tile, as in @c c_pfNodeGrid::fs_getIndex.
+ * @return The node of the tile at the step.
+ **********************************************************************************************************************/
+c_pfCooperativeNode &fg_getPfCooperativeNode(int p_step, size_t p_tile)
+{
+    return g_pfCooperativeNodes[static_cast<size_t>(p_step) * g_pfCooperativeLayerSize + p_tile];
+}
+
+}
+
+// Public members.
+#if 1
+
+    c_pfReservationTable::c_pfReservationTable()
+    : v_agents(g_pfCooperativeLayerSize * static_cast<size_t>(g_pfCooperativeWindow + 1), g_pfNoCooperativeAgent)
+    {
+
+    }
+
+    uint64_t c_pfReservationTable::f_getStep() const
+    {
+        return v_step;
+    }
+
+    void c_pfReservationTable::f_advanceTo(uint64_t p_step)
+    {
+        // The layer of a passed step becomes the layer of a step at the end of the window.
+        uint64_t l_passedSteps {min(p_step - v_step, static_cast<uint64_t>(g_pfCooperativeWindow + 1))};
+
+        for (uint64_t l_step {v_step}; l_step != v_step + l_passedSteps; ++l_step)
+        {
+            auto l_layer {v_agents.begin() + static_cast<ptrdiff_t>(fs_getIndex(0, 0, l_step))};
+            fill(l_layer, l_layer + static_cast<ptrdiff_t>(g_pfCooperativeLayerSize), g_pfNoCooperativeAgent);
+        }
+
+        v_step = p_step;
+    }
+
+    void c_pfReservationTable::f_clear()
+    {
+        fill(v_agents.begin(), v_agents.end(), g_pfNoCooperativeAgent);
+    }
+
+    void c_pfReservationTable::f_reserve(int p_x, int p_y, uint64_t p_step, uint32_t p_agent)
+    {
+        if (p_step < v_step || p_step - v_step > static_cast<uint64_t>(g_pfCooperativeWindow))
+            return;
+
+        uint32_t &l_agent {v_agents[fs_getIndex(p_x, p_y, p_step)]};
+
+        if (l_agent == g_pfNoCooperativeAgent)
+            l_agent = p_agent;
+    }
+
+    void c_pfReservationTable::f_release(int p_x, int p_y, uint64_t p_step, uint32_t p_agent)
+    {
+        if (p_step < v_step || p_step - v_step > static_cast<uint64_t>(g_pfCooperativeWindow))
+            return;
+
+        uint32_t &l_agent {v_agents[fs_getIndex(p_x, p_y, p_step)]};
+
+        if (l_agent == p_agent)
+            l_agent = g_pfNoCooperativeAgent;
+    }
+
+#endif
+
+bool fg_pfSearchCooperative(const c_worldView &p_world, const c_pfFlowField &p_flowField,
+const c_pfReservationTable &p_reservations, uint32_t p_agent, int p_fromX, int p_fromY, int p_fromHealth,
+vector<pair<int, int>> &p_positions, c_pfSearchStats &p_stats)
+{
+    using enum e_pfNodeDir;
+
+    uint16_t l_startCost {p_flowField.f_getCost(p_fromX, p_fromY, p_fromHealth)};
+
+    if (l_startCost == g_pfNoFlowCost)
+    {
+        p_positions.assign(static_cast<size_t>(g_pfCooperativeWindow + 1), {p_fromX, p_fromY});
+        return false;
+    }
+
+    if (g_pfCooperativeNodes.empty())
+        g_pfCooperativeNodes.resize(g_pfCooperativeLayerSize * static_cast<size_t>(g_pfCooperativeWindow + 1));
+
+    // Like in c_pfNodeGrid, the nodes are only cleared when the search ID wraps around.
+    if (++g_pfCooperativeSearchId == 0u)
+    {
+        fill(g_pfCooperativeNodes.begin(), g_pfCooperativeNodes.end(), c_pfCooperativeNode {});
+        g_pfCooperativeSearchId = 1u;
+    }
+
+    for (vector<c_pfCooperativeEntry> &l_bucket : g_pfCooperativeBuckets)
+        l_bucket.clear();
+
+    auto [l_goalX, l_goalY] {p_flowField.f_getGoal()};
+    uint64_t l_firstStep {p_reservations.f_getStep()};
+
+    // Every node of a step has the same cost so far, so a node only replaces another one with a higher health.
+    auto fl_push = [&](int p_x, int p_y, int p_step, int p_health, unsigned char p_action)
+    {
+        size_t               l_tile {c_pfNodeGrid::fs_getIndex(p_x, p_y)};
+        c_pfCooperativeNode &l_node {fg_getPfCooperativeNode(p_step, l_tile)};
+
+        if (l_node.v_searchId == g_pfCooperativeSearchId && l_node.v_health >= p_health)
+            return;
+
+        l_node.v_searchId = g_pfCooperativeSearchId;
+        l_node.v_health   = static_cast<unsigned char>(p_health);
+        l_node.v_action   = p_action;
+
+        size_t l_estimate {static_cast<size_t>(p_step) + p_flowField.f_getCost(p_x, p_y, p_health)};
+        size_t l_bucket   {min(l_estimate - l_startCost, g_pfCooperativeBuckets.size() - 1u)};
+
+        g_pfCooperativeBuckets[l_bucket].push_back
+        ({static_cast<uint32_t>(l_tile), static_cast<unsigned char>(p_step), static_cast<unsigned char>(p_health)});
+    };
+
+    // The goal ends the plan only if the agent can wait there until the end of the window.
+    auto fl_canWaitAtGoal = [&](int p_step) -> bool
+    {
+        for (int l_step {p_step + 1}; l_step <= g_pfCooperativeWindow; ++l_step)
+        {
+            if (!p_reservations.f_isFreeFor(l_goalX, l_goalY, l_firstStep + static_cast<uint64_t>(l_step), p_agent))
+                return false;
+        }
+
+        return true;
+    };
+
+    // Backtracks the plan to a node, and fills the rest of the positions with waiting at the node.
+    auto fl_backtrack = [&](int p_x, int p_y, int p_step, size_t p_positionCount)
+    {
+        p_positions.assign(p_positionCount, {p_x, p_y});
+
+        for (; p_step != 0; --p_step)
+        {
+            p_positions[static_cast<size_t>(p_step)] = {p_x, p_y};
+
+            size_t        l_tile   {c_pfNodeGrid::fs_getIndex(p_x, p_y)};
+            unsigned char l_action {fg_getPfCooperativeNode(p_step, l_tile).v_action};
+
+            if (l_action != g_pfCooperativeWait)
+            {
+                auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(static_cast<e_pfNodeDir>(l_action))};
+                p_x -= l_offsetX;
+                p_y -= l_offsetY;
+            }
+        }
+
+        p_positions[0] = {p_x, p_y};
+    };
+
+    // The first expanded node of the latest step, where the plan waits if no plan reaches the window's end.
+    int l_deepestX    {p_fromX};
+    int l_deepestY    {p_fromY};
+    int l_deepestStep {};
+
+    fl_push(p_fromX, p_fromY, 0, p_fromHealth, g_pfCooperativeWait);
+
+    for (vector<c_pfCooperativeEntry> &l_bucket : g_pfCooperativeBuckets)
+    {
+        while (!l_bucket.empty())
+        {
+            c_pfCooperativeEntry l_entry {l_bucket.back()};
+            l_bucket.pop_back();
+
+            if (fg_getPfCooperativeNode(l_entry.v_step, l_entry.v_tile).v_health != l_entry.v_health)
+                continue; // The node has been replaced since pushing.
+
+            ++p_stats.v_expandedNodes;
+
+            int l_x    {static_cast<int>(l_entry.v_tile / static_cast<uint32_t>(g_worldH))};
+            int l_y    {static_cast<int>(l_entry.v_tile % static_cast<uint32_t>(g_worldH))};
+            int l_step {l_entry.v_step};
+
+            if (l_step == g_pfCooperativeWindow || (l_x == l_goalX && l_y == l_goalY && fl_canWaitAtGoal(l_step)))
+            {
+                fl_backtrack(l_x, l_y, l_step, static_cast<size_t>(g_pfCooperativeWindow + 1));
+                return true;
+            }
+
+            if (l_step > l_deepestStep)
+            {
+                l_deepestX    = l_x;
+                l_deepestY    = l_y;
+                l_deepestStep = l_step;
+            }
+
+            uint64_t l_reservedStep {l_firstStep + static_cast<uint64_t>(l_step)};
+            int      l_health       {l_entry.v_health};
+
+            if (p_reservations.f_isFreeFor(l_x, l_y, l_reservedStep + 1u, p_agent))
+                fl_push(l_x, l_y, l_step + 1, l_health, g_pfCooperativeWait);
+
+            for (e_pfNodeDir l_dir : {ev_right, ev_down, ev_left, ev_up})
+            {
+                auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dir)};
+                int l_newX {l_x + l_offsetX};
+                int l_newY {l_y + l_offsetY};
+
+                if (!p_world.f_isFree(l_newX, l_newY))
+                    continue;
+
+                int l_newHealth {p_world.f_isPosNearWall(l_newX, l_newY) ? g_pfNodeMaxHealth : l_health - 1};
+
+                // Also leaves out the nodes with 0 health, except for the goal, which the flow field can't leave.
+                if (l_newHealth < 0 || p_flowField.f_getCost(l_newX, l_newY, l_newHealth) == g_pfNoFlowCost)
+                    continue;
+
+                if (!p_reservations.f_isFreeFor(l_newX, l_newY, l_reservedStep + 1u, p_agent))
+                    continue;
+
+                // The agent on the new tile may be moving to this tile, which would swap them.
+                uint32_t l_otherAgent {p_reservations.f_getAgent(l_newX, l_newY, l_reservedStep)};
+
+                if
+                (
+                    l_otherAgent != g_pfNoCooperativeAgent && l_otherAgent != p_agent &&
+                    p_reservations.f_getAgent(l_x, l_y, l_reservedStep + 1u) == l_otherAgent
+                )
+                {
+                    continue;
+                }
+
+                fl_push(l_newX, l_newY, l_step + 1, l_newHealth, static_cast<unsigned char>(l_dir));
+            }
+        }
+    }
+
+    fl_backtrack(l_deepestX, l_deepestY, l_deepestStep, static_cast<size_t>(g_pfCooperativeWindow + 1));
+    return false;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The cooperative pathfinding of several characters, which plan their moves around each other's.
+ * @details The planning is a windowed hierarchical cooperative A*-search. Every character plans its next
+ * @c g_pfCooperativeWindow steps with a search of space and time, in which waiting in place is a step too. The moves
+ * that have been planned are reserved in a table of tiles and steps, and the later planners may not step on them.
+ * Beyond the window, the search uses the character's flow field as the heuristic, which is the true number of steps
+ * to the goal when the other characters are ignored. So the window only has to solve the local conflicts, and the
+ * rest of the path follows the flow field.
+ *
+ * The characters plan in priority order, every character seeing the reservations of the ones before it. The plans
+ * are made again every half window, and the order is rotated every time, so that no character is always the last.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "pfFlowField.hpp"
+#include "pfNodeGrid.hpp"
+#include "pfSearch.hpp"
+#include "world.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+constexpr int      g_pfCooperativeWindow {16};         //!< The number of steps that a plan covers and reserves.
+constexpr uint32_t g_pfNoCooperativeAgent {UINT32_MAX}; //!< The agent of a tile and step that isn't reserved.
+
+/***********************************************************************************************************************
+ * @brief The statistics of a step of the cooperative planning.
+ **********************************************************************************************************************/
+class c_pfCooperativeStats
+{
+    public:
+
+    size_t   v_agentCount    {}; //!< The number of characters that plan cooperatively.
+    size_t   v_plannedAgents {}; //!< The number of characters that planned during the step.
+    size_t   v_blockedAgents {}; //!< The number of plans that didn't find a way and wait in place instead.
+    size_t   v_expandedNodes {}; //!< The nodes expanded by the plans, which are pairs of a tile and a step.
+    uint64_t v_microseconds  {}; //!< The wall-clock time of the step, including the moves and the plans.
+};
+
+/***********************************************************************************************************************
+ * @brief The tiles which the agents have reserved at the upcoming steps. Covers the steps from the current one to
+ * @c g_pfCooperativeWindow steps ahead, in a ring of world-sized layers, one per step.
+ **********************************************************************************************************************/
+class c_pfReservationTable
+{
+    private:
+
+    std::vector<uint32_t> v_agents {}; //!< The reserving agent of every tile and step, indexed with @c fs_getIndex.
+    uint64_t              v_step   {}; //!< The current step, which is the earliest one that can be reserved.
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @param p_step A step from the current one to @c g_pfCooperativeWindow steps ahead.
+     * @return The index of the tile and step in @c v_agents.
+     ******************************************************************************************************************/
+    static size_t fs_getIndex(int p_x, int p_y, uint64_t p_step);
+
+    public:
+
+    /*******************************************************************************************************************
+     * @brief Creates a table which covers the whole world. This is the only allocation the table does.
+     ******************************************************************************************************************/
+    c_pfReservationTable();
+
+    /*******************************************************************************************************************
+     * @return The current step.
+     ******************************************************************************************************************/
+    uint64_t f_getStep() const;
+
+    /*******************************************************************************************************************
+     * @brief Moves to a later step, and frees the layers of the steps that have passed for the steps that come into
+     * the window.
+     * @param p_step The new current step. Must not be earlier than the current step.
+     ******************************************************************************************************************/
+    void f_advanceTo(uint64_t p_step);
+
+    /*******************************************************************************************************************
+     * @brief Frees every reservation.
+     ******************************************************************************************************************/
+    void f_clear();
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @param p_step A step.
+     * @return The agent which has reserved the tile at the step. @c g_pfNoCooperativeAgent if none has, or if the step
+     * is outside the window.
+     ******************************************************************************************************************/
+    uint32_t f_getAgent(int p_x, int p_y, uint64_t p_step) const;
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @param p_step A step.
+     * @param p_agent An agent.
+     * @return True if no other agent has reserved the tile at the step.
+     ******************************************************************************************************************/
+    bool f_isFreeFor(int p_x, int p_y, uint64_t p_step, uint32_t p_agent) const;
+
+    /*******************************************************************************************************************
+     * @brief Reserves a tile at a step for an agent, unless another agent has reserved it already.
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @param p_step A step. Ignored if it's outside the window.
+     * @param p_agent The agent.
+     ******************************************************************************************************************/
+    void f_reserve(int p_x, int p_y, uint64_t p_step, uint32_t p_agent);
+
+    /*******************************************************************************************************************
+     * @brief Frees a tile at a step, if the agent has reserved it.
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @param p_step A step. Ignored if it's outside the window.
+     * @param p_agent The agent.
+     ******************************************************************************************************************/
+    void f_release(int p_x, int p_y, uint64_t p_step, uint32_t p_agent);
+};
+
+/***********************************************************************************************************************
+ * @brief Plans an agent's next steps around the other agents' reservations, with a search of space and time.
+ * @details A node is a tile at a step of the window, and its successors are the four neighbours and the tile itself
+ * at the next step. A step may not enter a tile that another agent has reserved at the next step, or swap tiles with
+ * another agent. Waiting doesn't cost health, and a move costs health like in the other searches. Every step costs 1
+ * and the heuristic is the flow field's cost of the tile and health, so the search finds the plan which is followed by
+ * the shortest path to the goal when the other agents are ignored after the window.
+ * @param p_world The world which is searched. Must be the live world, like the flow field's.
+ * @param p_flowField The flow field of the agent's goal, which is up to date.
+ * @param p_reservations The other agents' reservations.
+ * @param p_agent The agent, whose own reservations are ignored.
+ * @param p_fromX, p_fromY The agent's world-space tile position at the current step of the reservations.
+ * @param p_fromHealth The agent's health.
+ * @param p_positions Gets the planned position of every step of the window, the first one being the current one.
+ * When the goal is reached before the end of the window, the agent waits at the goal until the end. If no plan
+ * reaches the end, gets the plan that gets the furthest before running into the reservations, waiting at its end.
+ * Waiting at the start if the goal can't be reached.
+ * @param p_stats Gets the number of expanded nodes added to it.
+ * @return False if the flow field can't reach the goal from the start, or if every plan runs into the reservations.
+ **********************************************************************************************************************/
+bool fg_pfSearchCooperative(const c_worldView &p_world, const c_pfFlowField &p_flowField,
+const c_pfReservationTable &p_reservations, uint32_t p_agent, int p_fromX, int p_fromY, int p_fromHealth,
+std::vector<std::pair<int, int>> &p_positions, c_pfSearchStats &p_stats);
+
+inline size_t c_pfReservationTable::fs_getIndex(int p_x, int p_y, uint64_t p_step)
+{
+    size_t l_layer     {static_cast<size_t>(p_step % static_cast<uint64_t>(g_pfCooperativeWindow + 1))};
+    size_t l_layerSize {static_cast<size_t>(g_worldW) * static_cast<size_t>(g_worldH)};
+
+    return l_layer * l_layerSize + c_pfNodeGrid::fs_getIndex(p_x, p_y);
+}
+
+inline uint32_t c_pfReservationTable::f_getAgent(int p_x, int p_y, uint64_t p_step) const
+{
+    if (p_step < v_step || p_step - v_step > static_cast<uint64_t>(g_pfCooperativeWindow))
+        return g_pfNoCooperativeAgent;
+
+    return v_agents[fs_getIndex(p_x, p_y, p_step)];
+}
+
+inline bool c_pfReservationTable::f_isFreeFor(int p_x, int p_y, uint64_t p_step, uint32_t p_agent) const
+{
+    uint32_t l_agent {f_getAgent(p_x, p_y, p_step)};
+    return l_agent == g_pfNoCooperativeAgent || l_agent == p_agent;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of @c c_pfFlowField.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfFlowField.hpp"
+    #include "world.hpp"
+
+    #include <algorithm>
+    #include <unordered_map>
+
+    #include <SDL.h>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+constexpr int g_pfFlowHealthCount {g_pfNodeMaxHealth + 1}; //!< The number of healths from 0 to the maximum.
+
+//! The fields which are held by someone, by the index of their goal's tile.
+unordered_map<size_t, weak_ptr<c_pfFlowField>> g_pfFlowFields {};
+
+vector<uint32_t> g_pfFlowQueue {}; //!< The queue of a field's build, as indices of @c c_pfFlowField::v_costs.
+
+}
+
+// Private members.
+#if 1
+
+    size_t c_pfFlowField::fs_getCostIndex(int p_x, int p_y, int p_health)
+    {
+        return c_pfNodeGrid::fs_getIndex(p_x, p_y) * g_pfFlowHealthCount + static_cast<size_t>(p_health);
+    }
+
+    void c_pfFlowField::f_build()
+    {
+        using enum e_pfNodeDir;
+
+        uint64_t    l_startTime {SDL_GetPerformanceCounter()};
+        c_worldView l_world     {fg_getLiveWorldView()};
+
+        size_t l_tileCount {static_cast<size_t>(g_worldW) * static_cast<size_t>(g_worldH)};
+        v_costs.assign(l_tileCount * g_pfFlowHealthCount, g_pfNoFlowCost);
+        v_buildStats = {};
+        g_pfFlowQueue.clear();
+
+        // The goal may be reached with any health, including 0.
+        if (l_world.f_isFree(v_goalX, v_goalY))
+        {
+            for (int l_health {}; l_health != g_pfFlowHealthCount; ++l_health)
+            {
+                v_costs[fs_getCostIndex(v_goalX, v_goalY, l_health)] = 0u;
+                g_pfFlowQueue.push_back(static_cast<uint32_t>(fs_getCostIndex(v_goalX, v_goalY, l_health)));
+            }
+        }
+
+        // A breadth-first search backwards. A step from a tile S with the health HS to a tile T gives T the health
+        // HT, which is the maximum if T is near a wall, and HS - 1 otherwise. Only S with HS > 0 can be stepped from,
+        // and S itself has the maximum health if it's near a wall.
+
+        for (size_t l_head {}; l_head != g_pfFlowQueue.size(); ++l_head)
+        {
+            size_t   l_index        {g_pfFlowQueue[l_head]};
+            size_t   l_tile         {l_index / g_pfFlowHealthCount};
+            int      l_health       {static_cast<int>(l_index % g_pfFlowHealthCount)};
+            int      l_toX          {static_cast<int>(l_tile / g_worldH)};
+            int      l_toY          {static_cast<int>(l_tile % g_worldH)};
+            uint16_t l_newCost      {static_cast<uint16_t>(v_costs[l_index] + 1u)};
+            bool     l_isToNearWall {l_world.f_isPosNearWall(l_toX, l_toY)};
+
+            ++v_buildStats.v_expandedNodes;
+
+            // A tile near a wall always has the maximum health, so its other healths can't be stepped to.
+            if (l_isToNearWall && l_health != g_pfNodeMaxHealth)
+                continue;
+
+            for (e_pfNodeDir l_dir : {ev_right, ev_down, ev_left, ev_up})
+            {
+                auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dir)};
+                int l_fromX {l_toX + l_offsetX};
+                int l_fromY {l_toY + l_offsetY};
+
+                if (!l_world.f_isFree(l_fromX, l_fromY))
+                    continue;
+
+                bool l_isFromNearWall {l_world.f_isPosNearWall(l_fromX, l_fromY)};
+                int  l_minFromHealth  {l_isToNearWall ? 1 : l_health + 1};
+                int  l_maxFromHealth  {l_isToNearWall ? g_pfNodeMaxHealth : min(l_health + 1, g_pfNodeMaxHealth)};
+
+                if (l_isFromNearWall)
+                    l_minFromHealth = g_pfNodeMaxHealth;
+
+                for (int l_fromHealth {l_minFromHealth}; l_fromHealth <= l_maxFromHealth; ++l_fromHealth)
+                {
+                    size_t l_fromIndex {fs_getCostIndex(l_fromX, l_fromY, l_fromHealth)};
+
+                    if (v_costs[l_fromIndex] != g_pfNoFlowCost)
+                        continue;
+
+                    v_costs[l_fromIndex] = l_newCost;
+                    g_pfFlowQueue.push_back(static_cast<uint32_t>(l_fromIndex));
+                }
+            }
+        }
+
+        v_worldRevision = fg_getWorldRevision();
+        v_isBuilt = true;
+
+        v_buildStats.v_microseconds =
+            (SDL_GetPerformanceCounter() - l_startTime) * 1'000'000u / SDL_GetPerformanceFrequency();
+    }
+
+#endif
+
+// Public members.
+#if 1
+
+    c_pfFlowField::c_pfFlowField(int p_goalX, int p_goalY) : v_goalX {p_goalX}, v_goalY {p_goalY}
+    {
+
+    }
+
+    bool c_pfFlowField::f_update()
+    {
+        if (v_isBuilt && v_worldRevision == fg_getWorldRevision())
+            return false;
+
+        f_build();
+        return true;
+    }
+
+    pair<int, int> c_pfFlowField::f_getGoal() const
+    {
+        return {v_goalX, v_goalY};
+    }
+
+    bool c_pfFlowField::f_getNextStep(int p_x, int p_y, int p_health, e_pfNodeDir &p_dir) const
+    {
+        using enum e_pfNodeDir;
+
+        c_worldView l_world    {fg_getLiveWorldView()};
+        uint16_t    l_bestCost {g_pfNoFlowCost};
+
+        for (e_pfNodeDir l_dir : {ev_right, ev_down, ev_left, ev_up})
+        {
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dir)};
+            int l_x {p_x + l_offsetX};
+            int l_y {p_y + l_offsetY};
+
+            if (!l_world.f_isFree(l_x, l_y))
+                continue;
+
+            int l_health {l_world.f_isPosNearWall(l_x, l_y) ? g_pfNodeMaxHealth : p_health - 1};
+
+            if (l_health < 0)
+                continue;
+
+            uint16_t l_cost {v_costs[fs_getCostIndex(l_x, l_y, l_health)]};
+
+            if (l_cost < l_bestCost)
+            {
+                l_bestCost = l_cost;
+                p_dir = l_dir;
+            }
+        }
+
+        return l_bestCost != g_pfNoFlowCost;
+    }
+
+    uint16_t c_pfFlowField::f_getCost(int p_x, int p_y, int p_health) const
+    {
+        return v_costs[fs_getCostIndex(p_x, p_y, p_health)];
+    }
+
+    const c_pfSearchStats &c_pfFlowField::f_getBuildStats() const
+    {
+        return v_buildStats;
+    }
+
+#endif
+
+shared_ptr<c_pfFlowField> fg_getPfFlowField(int p_goalX, int p_goalY)
+{
+    weak_ptr<c_pfFlowField> &l_entry {g_pfFlowFields[c_pfNodeGrid::fs_getIndex(p_goalX, p_goalY)]};
+
+    if (shared_ptr<c_pfFlowField> l_field {l_entry.lock()})
+        return l_field;
+
+    // Forgets the fields that nobody holds anymore.
+    erase_if(g_pfFlowFields, [](const auto &p_pair) {return p_pair.second.expired();});
+
+    shared_ptr<c_pfFlowField> l_field {make_shared<c_pfFlowField>(p_goalX, p_goalY)};
+    g_pfFlowFields[c_pfNodeGrid::fs_getIndex(p_goalX, p_goalY)] = l_field;
+    return l_field;
+}
+
+}
\ No newline at end of file
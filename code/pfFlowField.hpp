@@ -0,0 +1,103 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The header file of @c c_pfFlowField.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "pfNodeGrid.hpp"
+#include "pfSearch.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+constexpr uint16_t g_pfNoFlowCost {UINT16_MAX}; //!< The cost of a tile and health that can't reach the goal.
+
+/***********************************************************************************************************************
+ * @brief The steps from every tile to a single goal, shared by every character that heads to the goal. Built once per
+ * revision of the world, however many characters use it.
+ * @details The field is an integration field: the number of steps to the goal from every tile and health, searched
+ * backwards from the goal with the same health rules as the other searches. Since the best step from a tile depends
+ * on the health that the character arrives with, the directions are picked from the integration field when asked.
+ **********************************************************************************************************************/
+class c_pfFlowField
+{
+    private:
+
+    int                   v_goalX         {}; //!< The goal's world-space tile X-position.
+    int                   v_goalY         {}; //!< The goal's world-space tile Y-position.
+    uint64_t              v_worldRevision {}; //!< The world's revision that the field was built at.
+    bool                  v_isBuilt       {}; //!< False until the field is built for the first time.
+    std::vector<uint16_t> v_costs         {}; //!< The steps to the goal, indexed with @c fs_getCostIndex.
+    c_pfSearchStats       v_buildStats    {}; //!< The statistics of the latest build.
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @param p_health A health of the tile's node.
+     * @return The index of the tile and health in @c v_costs.
+     ******************************************************************************************************************/
+    static size_t fs_getCostIndex(int p_x, int p_y, int p_health);
+
+    /*******************************************************************************************************************
+     * @brief Builds the field of the live world.
+     ******************************************************************************************************************/
+    void f_build();
+
+    public:
+
+    /*******************************************************************************************************************
+     * @param p_goalX, p_goalY The goal's world-space tile position. Must be inside the world's boundaries.
+     ******************************************************************************************************************/
+    c_pfFlowField(int p_goalX, int p_goalY);
+
+    /*******************************************************************************************************************
+     * @brief Rebuilds the field if the world has changed since it was built. May only be called on the main thread.
+     * @return True if the field was rebuilt.
+     ******************************************************************************************************************/
+    bool f_update();
+
+    /*******************************************************************************************************************
+     * @return The goal's world-space tile position.
+     ******************************************************************************************************************/
+    std::pair<int, int> f_getGoal() const;
+
+    /*******************************************************************************************************************
+     * @brief Picks the step towards the goal that leads to the goal in the fewest steps.
+     * @param p_x, p_y The world-space tile position. Must be inside the world's boundaries.
+     * @param p_health The health of the character's node on the tile. The start has the maximum health.
+     * @param p_dir Gets the direction of the step.
+     * @return False if the goal can't be reached from the tile with the health.
+     ******************************************************************************************************************/
+    bool f_getNextStep(int p_x, int p_y, int p_health, e_pfNodeDir &p_dir) const;
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @param p_health A health from 0 to the maximum.
+     * @return The number of steps to the goal from the tile with the health. @c g_pfNoFlowCost if the goal can't be
+     * reached from it.
+     ******************************************************************************************************************/
+    uint16_t f_getCost(int p_x, int p_y, int p_health) const;
+
+    /*******************************************************************************************************************
+     * @return The statistics of the latest build. The expanded nodes are pairs of a tile and a health.
+     ******************************************************************************************************************/
+    const c_pfSearchStats &f_getBuildStats() const;
+};
+
+/***********************************************************************************************************************
+ * @brief Gets the flow field of a goal, which is shared by everyone who holds it. The field is freed when the last
+ * holder releases it.
+ * @param p_goalX, p_goalY The goal's world-space tile position. Must be inside the world's boundaries.
+ * @return The goal's field. It's up to date only after @c c_pfFlowField::f_update.
+ **********************************************************************************************************************/
+std::shared_ptr<c_pfFlowField> fg_getPfFlowField(int p_goalX, int p_goalY);
+
+}
\ No newline at end of file
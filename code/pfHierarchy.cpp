@@ -0,0 +1,622 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The hierarchical pathfinding, which plans a path over clusters of tiles before refining it into steps.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfHierarchy.hpp"
+    #include "world.hpp"
+
+    #include <algorithm>
+    #include <array>
+    #include <cstdlib>
+    #include <utility>
+    #include <vector>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+static_assert(g_worldW % g_pfClusterSize == 0 && g_worldH % g_pfClusterSize == 0);
+
+constexpr int g_pfClustersW               {g_worldW / g_pfClusterSize}; //!< The number of cluster columns.
+constexpr int g_pfClustersH               {g_worldH / g_pfClusterSize}; //!< The number of cluster rows.
+constexpr int g_pfMaxClusterEntrances     {g_pfClusterSize * 4 - 4}; //!< A cluster's number of border tiles.
+constexpr int g_pfMaxEntranceRunLength    {5}; //!< Longer runs of crossable tiles get an entrance at both ends.
+constexpr int g_pfMinHierarchicalDistance {g_pfClusterSize * 4}; //!< Nearer goals are searched over the tiles.
+
+constexpr uint16_t g_pfNoEntranceCost {UINT16_MAX}; //!< The cost between entrances with no path between them.
+
+/***********************************************************************************************************************
+ * @brief The entrances of a cluster and the costs between them.
+ **********************************************************************************************************************/
+class c_pfCluster
+{
+    public:
+
+    vector<pair<int, int>> v_entrances {}; //!< The entrances' world-space tile positions.
+    vector<uint16_t>       v_costs     {}; //!< The cost from the entrance I to the entrance J is at I * count + J.
+};
+
+/***********************************************************************************************************************
+ * @brief A node of a search within a single cluster.
+ **********************************************************************************************************************/
+class c_pfClusterNode
+{
+    public:
+
+    uint16_t      v_cost      {}; //!< The number of steps from the start of the search.
+    unsigned char v_health    {}; //!< The health of the node, as in @c c_pfNode.
+    e_pfNodeDir   v_dir       {}; //!< The direction towards the node which this node was spread from.
+    bool          v_isVisited {}; //!< True if the node has been spread to.
+};
+
+/***********************************************************************************************************************
+ * @brief A node of a search over the entrances, indexed with @c fg_getPfEntranceId.
+ **********************************************************************************************************************/
+class c_pfEntranceNode
+{
+    public:
+
+    uint32_t v_searchId {}; //!< The search which last visited the node. 0 is never a valid search ID.
+    uint32_t v_cost     {}; //!< The cost from the start.
+    int      v_parentId {}; //!< The entrance which this node was reached from, or -1 for the start.
+};
+
+/***********************************************************************************************************************
+ * @brief An entry of the open list of a search over the entrances. Stale entries are skipped when popped.
+ **********************************************************************************************************************/
+class c_pfEntranceOpenEntry
+{
+    public:
+
+    uint32_t v_estimate {}; //!< The cost so far plus the heuristic.
+    uint32_t v_cost     {}; //!< The cost so far.
+    int      v_id       {}; //!< The entrance's ID.
+};
+
+array<c_pfCluster, g_pfClustersW * g_pfClustersH> g_pfClusters {}; //!< The clusters, indexed with X * rows + Y.
+
+//! The index of every tile in its cluster's entrances, or -1 if the tile is not an entrance.
+array<array<signed char, g_worldH>, g_worldW> g_pfEntranceIndices {};
+
+uint64_t g_pfHierarchyRevision {}; //!< The world's revision that the clusters are up to date with.
+bool     g_isPfHierarchyBuilt  {}; //!< False until the clusters are built for the first time.
+
+vector<pair<int, int>> g_pfEditPositions {}; //!< The edits that the clusters are being updated with.
+
+array<c_pfClusterNode, g_pfClusterSize * g_pfClusterSize> g_pfClusterNodes {}; //!< The nodes of a cluster's search.
+vector<pair<int, int>> g_pfClusterProcessablePositions {}; //!< A cluster search's wavefront which is being spread.
+vector<pair<int, int>> g_pfClusterNewPositions         {}; //!< A cluster search's wavefront which is being built.
+
+//! The nodes of a search over the entrances. The last one is the goal's.
+vector<c_pfEntranceNode>      g_pfEntranceNodes    {};
+uint32_t                      g_pfEntranceSearchId {}; //!< The ID of the current search over the entrances.
+vector<c_pfEntranceOpenEntry> g_pfEntranceOpenList {}; //!< The open list of a search over the entrances, as a heap.
+vector<uint32_t>              g_pfGoalCosts        {}; //!< The cost from every entrance of the goal's cluster.
+vector<pair<int, int>>        g_pfWaypoints        {}; //!< The entrances of a found path, from the goal backwards.
+vector<e_pfNodeDir>           g_pfSegmentSteps     {}; //!< The steps of a refined segment, from its end backwards.
+
+/***********************************************************************************************************************
+ * @param p_x, p_y A world-space tile position inside the world's boundaries.
+ * @return The index of the tile's cluster in @c g_pfClusters.
+ **********************************************************************************************************************/
+int fg_getPfClusterIndex(int p_x, int p_y)
+{
+    return p_x / g_pfClusterSize * g_pfClustersH + p_y / g_pfClusterSize;
+}
+
+/***********************************************************************************************************************
+ * @param p_x, p_y A world-space tile position inside the world's boundaries.
+ * @return The tile's node in @c g_pfClusterNodes.
+ **********************************************************************************************************************/
+c_pfClusterNode &fg_getPfClusterNode(int p_x, int p_y)
+{
+    return g_pfClusterNodes[static_cast<size_t>(p_x % g_pfClusterSize * g_pfClusterSize + p_y % g_pfClusterSize)];
+}
+
+/***********************************************************************************************************************
+ * @param p_x, p_y The world-space tile position of an entrance.
+ * @return The entrance's index in @c g_pfEntranceNodes.
+ **********************************************************************************************************************/
+int fg_getPfEntranceId(int p_x, int p_y)
+{
+    return fg_getPfClusterIndex(p_x, p_y) * g_pfMaxClusterEntrances + g_pfEntranceIndices[p_x][p_y];
+}
+
+/***********************************************************************************************************************
+ * @param p_id The ID of an entrance.
+ * @return The entrance's world-space tile position.
+ **********************************************************************************************************************/
+pair<int, int> fg_getPfEntrancePos(int p_id)
+{
+    const c_pfCluster &l_cluster {g_pfClusters[static_cast<size_t>(p_id / g_pfMaxClusterEntrances)]};
+    return l_cluster.v_entrances[static_cast<size_t>(p_id % g_pfMaxClusterEntrances)];
+}
+
+/***********************************************************************************************************************
+ * @brief Spreads a wavefront from a tile to every tile of its cluster that it can reach, following the same rules as
+ * the search over the whole world. The results are left in @c g_pfClusterNodes.
+ * @param p_fromX, p_fromY The start's world-space tile position. The start has the maximum health.
+ * @return The number of expanded nodes.
+ **********************************************************************************************************************/
+size_t fg_pfSpreadInCluster(int p_fromX, int p_fromY)
+{
+    using enum e_pfNodeDir;
+
+    int    l_clusterX      {p_fromX - p_fromX % g_pfClusterSize};
+    int    l_clusterY      {p_fromY - p_fromY % g_pfClusterSize};
+    size_t l_expandedNodes {};
+
+    fill(g_pfClusterNodes.begin(), g_pfClusterNodes.end(), c_pfClusterNode {});
+    g_pfClusterProcessablePositions.clear();
+    g_pfClusterNewPositions.clear();
+
+    fg_getPfClusterNode(p_fromX, p_fromY) = {0u, static_cast<unsigned char>(g_pfNodeMaxHealth), ev_right, true};
+    g_pfClusterNewPositions.push_back({p_fromX, p_fromY});
+
+    while (!g_pfClusterNewPositions.empty())
+    {
+        g_pfClusterProcessablePositions.swap(g_pfClusterNewPositions);
+        g_pfClusterNewPositions.clear();
+
+        for (auto [l_fromX, l_fromY] : g_pfClusterProcessablePositions)
+        {
+            const c_pfClusterNode &l_fromNode {fg_getPfClusterNode(l_fromX, l_fromY)};
+
+            ++l_expandedNodes;
+
+            for (e_pfNodeDir l_dir : {ev_right, ev_down, ev_left, ev_up})
+            {
+                auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dir)};
+                int l_x {l_fromX + l_offsetX};
+                int l_y {l_fromY + l_offsetY};
+
+                if
+                (
+                    l_x < l_clusterX || l_x >= l_clusterX + g_pfClusterSize ||
+                    l_y < l_clusterY || l_y >= l_clusterY + g_pfClusterSize ||
+                    g_staticObjs[l_x][l_y] != 0u
+                )
+                {
+                    continue;
+                }
+
+                c_pfClusterNode &l_node {fg_getPfClusterNode(l_x, l_y)};
+
+                if (l_node.v_isVisited && l_node.v_health != 0u)
+                    continue;
+
+                int l_health {fg_isPosNearWall(l_x, l_y) ? g_pfNodeMaxHealth : l_fromNode.v_health - 1};
+                l_node =
+                {
+                    static_cast<uint16_t>(l_fromNode.v_cost + 1u), static_cast<unsigned char>(l_health),
+                    fg_pfReverseDir(l_dir), true
+                };
+
+                if (l_node.v_health != 0u)
+                    g_pfClusterNewPositions.push_back({l_x, l_y});
+            }
+        }
+    }
+
+    return l_expandedNodes;
+}
+
+/***********************************************************************************************************************
+ * @brief Finds the entrances on one side of a cluster and adds them to the cluster. A pair of facing free tiles on
+ * either side of the border can be crossed if both are next to a wall. Every run of such pairs gets an entrance in its
+ * middle, or at both ends if it's long. Both clusters get the same pairs, since they're found with the same rules.
+ * @param p_cluster The cluster.
+ * @param p_firstX, p_firstY The world-space tile position of the side's first tile.
+ * @param p_alongX, p_alongY The tile offset along the side.
+ * @param p_acrossX, p_acrossY The tile offset across the border.
+ **********************************************************************************************************************/
+void fg_addPfClusterEntrances(c_pfCluster &p_cluster, int p_firstX, int p_firstY, int p_alongX, int p_alongY,
+int p_acrossX, int p_acrossY)
+{
+    auto fl_isCrossable = [&](int p_index) -> bool
+    {
+        if (p_index >= g_pfClusterSize)
+            return false;
+
+        int l_x {p_firstX + p_alongX * p_index};
+        int l_y {p_firstY + p_alongY * p_index};
+        int l_acrossX {l_x + p_acrossX};
+        int l_acrossY {l_y + p_acrossY};
+
+        return
+            fg_isPosInWorldBounds(l_acrossX, l_acrossY) &&
+            g_staticObjs[l_x][l_y] == 0u && g_staticObjs[l_acrossX][l_acrossY] == 0u &&
+            fg_isPosNearWall(l_x, l_y) && fg_isPosNearWall(l_acrossX, l_acrossY);
+    };
+
+    auto fl_addEntrance = [&](int p_index)
+    {
+        int l_x {p_firstX + p_alongX * p_index};
+        int l_y {p_firstY + p_alongY * p_index};
+
+        // A corner tile can be an entrance on two sides.
+        if (g_pfEntranceIndices[l_x][l_y] != -1)
+            return;
+
+        g_pfEntranceIndices[l_x][l_y] = static_cast<signed char>(p_cluster.v_entrances.size());
+        p_cluster.v_entrances.push_back({l_x, l_y});
+    };
+
+    for (int l_runStart {}; l_runStart != g_pfClusterSize;)
+    {
+        if (!fl_isCrossable(l_runStart))
+        {
+            ++l_runStart;
+            continue;
+        }
+
+        int l_runEnd {l_runStart + 1};
+
+        while (fl_isCrossable(l_runEnd))
+            ++l_runEnd;
+
+        if (l_runEnd - l_runStart > g_pfMaxEntranceRunLength)
+        {
+            fl_addEntrance(l_runStart);
+            fl_addEntrance(l_runEnd - 1);
+        }
+        else
+            fl_addEntrance((l_runStart + l_runEnd - 1) / 2);
+
+        l_runStart = l_runEnd;
+    }
+}
+
+/***********************************************************************************************************************
+ * @brief Rebuilds a cluster's entrances and the costs between them.
+ * @param p_clusterX, p_clusterY The cluster's position in clusters.
+ **********************************************************************************************************************/
+void fg_rebuildPfCluster(int p_clusterX, int p_clusterY)
+{
+    c_pfCluster &l_cluster {g_pfClusters[static_cast<size_t>(p_clusterX * g_pfClustersH + p_clusterY)]};
+    int          l_firstX  {p_clusterX * g_pfClusterSize};
+    int          l_firstY  {p_clusterY * g_pfClusterSize};
+    int          l_lastX   {l_firstX + g_pfClusterSize - 1};
+    int          l_lastY   {l_firstY + g_pfClusterSize - 1};
+
+    for (auto [l_x, l_y] : l_cluster.v_entrances)
+        g_pfEntranceIndices[l_x][l_y] = -1;
+
+    l_cluster.v_entrances.clear();
+
+    fg_addPfClusterEntrances(l_cluster, l_firstX, l_firstY, 0, 1, -1,  0);
+    fg_addPfClusterEntrances(l_cluster, l_lastX,  l_firstY, 0, 1,  1,  0);
+    fg_addPfClusterEntrances(l_cluster, l_firstX, l_firstY, 1, 0,  0, -1);
+    fg_addPfClusterEntrances(l_cluster, l_firstX, l_lastY,  1, 0,  0,  1);
+
+    size_t l_entranceCount {l_cluster.v_entrances.size()};
+    l_cluster.v_costs.assign(l_entranceCount * l_entranceCount, g_pfNoEntranceCost);
+
+    for (size_t l_from {}; l_from != l_entranceCount; ++l_from)
+    {
+        fg_pfSpreadInCluster(l_cluster.v_entrances[l_from].first, l_cluster.v_entrances[l_from].second);
+
+        for (size_t l_to {}; l_to != l_entranceCount; ++l_to)
+        {
+            const c_pfClusterNode &l_node
+            {fg_getPfClusterNode(l_cluster.v_entrances[l_to].first, l_cluster.v_entrances[l_to].second)};
+
+            if (l_node.v_isVisited)
+                l_cluster.v_costs[l_from * l_entranceCount + l_to] = l_node.v_cost;
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * @brief Adds the steps from a tile to a tile of the same cluster to the nodes of a search. A tile which has already
+ * been visited keeps its direction, which cuts out any loop that the path makes through it.
+ * @param p_fromX, p_fromY The segment's first world-space tile position.
+ * @param p_toX, p_toY The segment's last world-space tile position. Must be reachable from the first one.
+ * @param p_pfNodes The nodes of the search.
+ * @return The number of expanded nodes.
+ **********************************************************************************************************************/
+size_t fg_pfRefineSegment(int p_fromX, int p_fromY, int p_toX, int p_toY, c_pfNodeGrid &p_pfNodes)
+{
+    size_t l_expandedNodes {fg_pfSpreadInCluster(p_fromX, p_fromY)};
+
+    g_pfSegmentSteps.clear();
+
+    for (int l_x {p_toX}, l_y {p_toY}; l_x != p_fromX || l_y != p_fromY;)
+    {
+        e_pfNodeDir l_dirToPrev {fg_getPfClusterNode(l_x, l_y).v_dir};
+        auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dirToPrev)};
+        l_x += l_offsetX;
+        l_y += l_offsetY;
+
+        g_pfSegmentSteps.push_back(fg_pfReverseDir(l_dirToPrev));
+    }
+
+    int l_x {p_fromX};
+    int l_y {p_fromY};
+
+    for (auto l_it {g_pfSegmentSteps.rbegin()}; l_it != g_pfSegmentSteps.rend(); ++l_it)
+    {
+        auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(*l_it)};
+        l_x += l_offsetX;
+        l_y += l_offsetY;
+
+        if (!p_pfNodes.f_isVisited(l_x, l_y))
+            p_pfNodes.f_visit(l_x, l_y).v_dir = fg_pfReverseDir(*l_it);
+    }
+
+    return l_expandedNodes;
+}
+
+/***********************************************************************************************************************
+ * @brief Checks the path that the refined segments were joined into against the health rules. The segments are valid
+ * on their own, since they begin at the start or at entrances, which have the maximum health. But a tile that several
+ * segments go through keeps the node of the earliest one, so the path goes on from it with that segment's health,
+ * which may be too little for the rest of the path.
+ * @param p_fromX, p_fromY The start's world-space tile position.
+ * @param p_goalX, p_goalY The goal's world-space tile position.
+ * @param p_pfNodes The nodes of the search, along which the path can be backtracked from the goal.
+ * @return True if no tile of the path but the goal is reached with 0 health.
+ **********************************************************************************************************************/
+bool fg_isPfJoinedPathValid(int p_fromX, int p_fromY, int p_goalX, int p_goalY, const c_pfNodeGrid &p_pfNodes)
+{
+    g_pfSegmentSteps.clear();
+
+    for (int l_x {p_goalX}, l_y {p_goalY}; l_x != p_fromX || l_y != p_fromY;)
+    {
+        e_pfNodeDir l_dirToPrev {p_pfNodes.f_getNode(l_x, l_y).v_dir};
+        auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dirToPrev)};
+        l_x += l_offsetX;
+        l_y += l_offsetY;
+
+        g_pfSegmentSteps.push_back(fg_pfReverseDir(l_dirToPrev));
+    }
+
+    int l_x      {p_fromX};
+    int l_y      {p_fromY};
+    int l_health {g_pfNodeMaxHealth};
+
+    for (auto l_it {g_pfSegmentSteps.rbegin()}; l_it != g_pfSegmentSteps.rend(); ++l_it)
+    {
+        if (l_health == 0)
+            return false;
+
+        auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(*l_it)};
+        l_x += l_offsetX;
+        l_y += l_offsetY;
+        l_health = fg_isPosNearWall(l_x, l_y) ? g_pfNodeMaxHealth : l_health - 1;
+    }
+
+    return true;
+}
+
+}
+
+void fg_updatePfHierarchy()
+{
+    uint64_t l_revision {fg_getWorldRevision()};
+
+    if (g_isPfHierarchyBuilt && g_pfHierarchyRevision == l_revision)
+        return;
+
+    g_pfEditPositions.clear();
+
+    if (!g_isPfHierarchyBuilt || !fg_getWorldEditsSince(g_pfHierarchyRevision, g_pfEditPositions))
+    {
+        for (array<signed char, g_worldH> &l_column : g_pfEntranceIndices)
+            l_column.fill(-1);
+
+        for (c_pfCluster &l_cluster : g_pfClusters)
+            l_cluster.v_entrances.clear();
+
+        for (int l_clusterX {}; l_clusterX != g_pfClustersW; ++l_clusterX)
+            for (int l_clusterY {}; l_clusterY != g_pfClustersH; ++l_clusterY)
+                fg_rebuildPfCluster(l_clusterX, l_clusterY);
+    }
+    else
+    {
+        array<bool, g_pfClustersW * g_pfClustersH> l_isClusterDirty {};
+
+        // An edit changes whether the tiles around it are next to a wall, and the entrances between those tiles and
+        // the tiles across a border.
+        for (auto [l_x, l_y] : g_pfEditPositions)
+        {
+            int l_fromClusterX {max(0, l_x - 2) / g_pfClusterSize};
+            int l_fromClusterY {max(0, l_y - 2) / g_pfClusterSize};
+            int l_toClusterX   {min(g_worldW - 1, l_x + 2) / g_pfClusterSize};
+            int l_toClusterY   {min(g_worldH - 1, l_y + 2) / g_pfClusterSize};
+
+            for (int l_clusterX {l_fromClusterX}; l_clusterX <= l_toClusterX; ++l_clusterX)
+                for (int l_clusterY {l_fromClusterY}; l_clusterY <= l_toClusterY; ++l_clusterY)
+                    l_isClusterDirty[static_cast<size_t>(l_clusterX * g_pfClustersH + l_clusterY)] = true;
+        }
+
+        for (int l_clusterX {}; l_clusterX != g_pfClustersW; ++l_clusterX)
+            for (int l_clusterY {}; l_clusterY != g_pfClustersH; ++l_clusterY)
+                if (l_isClusterDirty[static_cast<size_t>(l_clusterX * g_pfClustersH + l_clusterY)])
+                    fg_rebuildPfCluster(l_clusterX, l_clusterY);
+    }
+
+    g_pfHierarchyRevision = l_revision;
+    g_isPfHierarchyBuilt = true;
+}
+
+bool fg_pfSearchHierarchical(int p_fromX, int p_fromY, int p_goalX, int p_goalY, c_pfNodeGrid &p_pfNodes,
+c_pfSearchStats &p_stats)
+{
+    using enum e_pfNodeDir;
+
+    if (!fg_isPosInWorldBounds(p_goalX, p_goalY) || g_staticObjs[p_goalX][p_goalY] != 0u)
+        return false;
+
+    if (abs(p_goalX - p_fromX) + abs(p_goalY - p_fromY) < g_pfMinHierarchicalDistance)
+        return false;
+
+    fg_updatePfHierarchy();
+
+    constexpr int l_goalId {g_pfClustersW * g_pfClustersH * g_pfMaxClusterEntrances};
+
+    if (g_pfEntranceNodes.empty())
+        g_pfEntranceNodes.resize(static_cast<size_t>(l_goalId) + 1u);
+
+    if (++g_pfEntranceSearchId == 0u)
+    {
+        fill(g_pfEntranceNodes.begin(), g_pfEntranceNodes.end(), c_pfEntranceNode {});
+        g_pfEntranceSearchId = 1u;
+    }
+
+    auto fl_isWorse = [](const c_pfEntranceOpenEntry &p_a, const c_pfEntranceOpenEntry &p_b) -> bool
+    {
+        return p_a.v_estimate > p_b.v_estimate;
+    };
+
+    // Visits a node if it's new or cheaper than before.
+    auto fl_reach = [&](int p_id, uint32_t p_cost, int p_parentId, int p_x, int p_y)
+    {
+        c_pfEntranceNode &l_node {g_pfEntranceNodes[static_cast<size_t>(p_id)]};
+
+        if (l_node.v_searchId == g_pfEntranceSearchId && l_node.v_cost <= p_cost)
+            return;
+
+        l_node = {g_pfEntranceSearchId, p_cost, p_parentId};
+
+        uint32_t l_heuristic {static_cast<uint32_t>(abs(p_goalX - p_x) + abs(p_goalY - p_y))};
+        g_pfEntranceOpenList.push_back({p_cost + l_heuristic, p_cost, p_id});
+        push_heap(g_pfEntranceOpenList.begin(), g_pfEntranceOpenList.end(), fl_isWorse);
+    };
+
+    g_pfEntranceOpenList.clear();
+
+    // The costs from the start to its cluster's entrances, and from the goal's cluster's entrances to the goal.
+
+    int                l_goalClusterIndex {fg_getPfClusterIndex(p_goalX, p_goalY)};
+    const c_pfCluster &l_goalCluster      {g_pfClusters[static_cast<size_t>(l_goalClusterIndex)]};
+    const c_pfCluster &l_startCluster     {g_pfClusters[static_cast<size_t>(fg_getPfClusterIndex(p_fromX, p_fromY))]};
+
+    g_pfGoalCosts.assign(l_goalCluster.v_entrances.size(), g_pfNoEntranceCost);
+
+    for (size_t l_index {}; l_index != l_goalCluster.v_entrances.size(); ++l_index)
+    {
+        p_stats.v_expandedNodes +=
+            fg_pfSpreadInCluster(l_goalCluster.v_entrances[l_index].first, l_goalCluster.v_entrances[l_index].second);
+
+        const c_pfClusterNode &l_node {fg_getPfClusterNode(p_goalX, p_goalY)};
+
+        if (l_node.v_isVisited)
+            g_pfGoalCosts[l_index] = l_node.v_cost;
+    }
+
+    p_stats.v_expandedNodes += fg_pfSpreadInCluster(p_fromX, p_fromY);
+
+    for (auto [l_x, l_y] : l_startCluster.v_entrances)
+    {
+        const c_pfClusterNode &l_node {fg_getPfClusterNode(l_x, l_y)};
+
+        if (l_node.v_isVisited)
+            fl_reach(fg_getPfEntranceId(l_x, l_y), l_node.v_cost, -1, l_x, l_y);
+    }
+
+    // The search over the entrances.
+
+    bool l_isFound {};
+
+    while (!g_pfEntranceOpenList.empty())
+    {
+        pop_heap(g_pfEntranceOpenList.begin(), g_pfEntranceOpenList.end(), fl_isWorse);
+        c_pfEntranceOpenEntry l_entry {g_pfEntranceOpenList.back()};
+        g_pfEntranceOpenList.pop_back();
+
+        if (l_entry.v_cost != g_pfEntranceNodes[static_cast<size_t>(l_entry.v_id)].v_cost)
+            continue; // The node has been reached more cheaply since pushing.
+
+        if (l_entry.v_id == l_goalId)
+        {
+            l_isFound = true;
+            break;
+        }
+
+        ++p_stats.v_expandedNodes;
+
+        int                l_clusterIndex {l_entry.v_id / g_pfMaxClusterEntrances};
+        size_t             l_index        {static_cast<size_t>(l_entry.v_id % g_pfMaxClusterEntrances)};
+        const c_pfCluster &l_cluster      {g_pfClusters[static_cast<size_t>(l_clusterIndex)]};
+        size_t             l_count        {l_cluster.v_entrances.size()};
+        auto [l_fromX, l_fromY] {fg_getPfEntrancePos(l_entry.v_id)};
+
+        if (l_clusterIndex == l_goalClusterIndex && g_pfGoalCosts[l_index] != g_pfNoEntranceCost)
+            fl_reach(l_goalId, l_entry.v_cost + g_pfGoalCosts[l_index], l_entry.v_id, p_goalX, p_goalY);
+
+        for (size_t l_to {}; l_to != l_count; ++l_to)
+        {
+            uint16_t l_cost {l_cluster.v_costs[l_index * l_count + l_to]};
+
+            if (l_to != l_index && l_cost != g_pfNoEntranceCost)
+            {
+                auto [l_x, l_y] {l_cluster.v_entrances[l_to]};
+                fl_reach(fg_getPfEntranceId(l_x, l_y), l_entry.v_cost + l_cost, l_entry.v_id, l_x, l_y);
+            }
+        }
+
+        // The entrances across the cluster's borders.
+        for (e_pfNodeDir l_dir : {ev_right, ev_down, ev_left, ev_up})
+        {
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dir)};
+            int l_x {l_fromX + l_offsetX};
+            int l_y {l_fromY + l_offsetY};
+
+            if
+            (
+                fg_isPosInWorldBounds(l_x, l_y) && g_pfEntranceIndices[l_x][l_y] != -1 &&
+                fg_getPfClusterIndex(l_x, l_y) != l_clusterIndex
+            )
+            {
+                fl_reach(fg_getPfEntranceId(l_x, l_y), l_entry.v_cost + 1u, l_entry.v_id, l_x, l_y);
+            }
+        }
+    }
+
+    if (!l_isFound)
+        return false;
+
+    // Refines the path segment by segment, from the start to the goal.
+
+    g_pfWaypoints.clear();
+    g_pfWaypoints.push_back({p_goalX, p_goalY});
+
+    for (int l_id {g_pfEntranceNodes[static_cast<size_t>(l_goalId)].v_parentId}; l_id != -1;)
+    {
+        g_pfWaypoints.push_back(fg_getPfEntrancePos(l_id));
+
+        l_id = g_pfEntranceNodes[static_cast<size_t>(l_id)].v_parentId;
+    }
+
+    g_pfWaypoints.push_back({p_fromX, p_fromY});
+    p_pfNodes.f_visit(p_fromX, p_fromY).v_health = static_cast<unsigned char>(g_pfNodeMaxHealth);
+
+    for (size_t l_index {g_pfWaypoints.size() - 1u}; l_index != 0u; --l_index)
+    {
+        auto [l_fromX, l_fromY] {g_pfWaypoints[l_index]};
+        auto [l_toX,   l_toY]   {g_pfWaypoints[l_index - 1u]};
+
+        if (fg_getPfClusterIndex(l_fromX, l_fromY) == fg_getPfClusterIndex(l_toX, l_toY))
+            p_stats.v_expandedNodes += fg_pfRefineSegment(l_fromX, l_fromY, l_toX, l_toY, p_pfNodes);
+        else if (!p_pfNodes.f_isVisited(l_toX, l_toY))
+            p_pfNodes.f_visit(l_toX, l_toY).v_dir = fg_pfOffsetToDir(l_fromX - l_toX, l_fromY - l_toY);
+    }
+
+    // A path that can't be followed is given up on, so that the caller searches over the tiles instead.
+    return fg_isPfJoinedPathValid(p_fromX, p_fromY, p_goalX, p_goalY, p_pfNodes);
+}
+
+}
\ No newline at end of file
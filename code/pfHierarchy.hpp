@@ -0,0 +1,48 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The hierarchical pathfinding, which plans a path over clusters of tiles before refining it into steps.
+ * @details The world is divided into square clusters. The tiles where a path may cross from a cluster to its
+ * neighbour are the entrances, and the costs between the entrances of every cluster are precomputed. A search first
+ * finds a path over the entrances, and then the steps between consecutive entrances, which only needs searches within
+ * the clusters that are crossed.
+ *
+ * Entrances are only placed next to walls, where a node gets the maximum health no matter which path led to it. This
+ * lets the path's segments be searched independently without breaking the health rules, but paths which cross
+ * clusters only away from walls aren't found.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "pfNodeGrid.hpp"
+#include "pfSearch.hpp"
+
+
+
+
+namespace n_tdg
+{
+
+constexpr int g_pfClusterSize {16}; //!< The width and height of a cluster, in tiles.
+
+/***********************************************************************************************************************
+ * @brief Brings the clusters up to date with the world. Only the clusters near the edited tiles are rebuilt, unless
+ * the edits are no longer known. Called by @c fg_pfSearchHierarchical, so this is only needed for choosing when the
+ * work is done.
+ **********************************************************************************************************************/
+void fg_updatePfHierarchy();
+
+/***********************************************************************************************************************
+ * @brief Searches for a path over the clusters' entrances, and refines it into nodes. The path can be backtracked from
+ * the goal by following the nodes' directions until the start. Only the nodes' directions are set.
+ * @param p_fromX, p_fromY The start's world-space tile position.
+ * @param p_goalX, p_goalY The goal's world-space tile position.
+ * @param p_pfNodes The nodes of the search, in which a search has been begun.
+ * @param p_stats Gets the number of expanded entrances and tiles added to it.
+ * @return True if the goal was found. False if there's no path over the entrances, if the start and the goal are too
+ * near each other for the clusters to help, or if the refined path breaks the health rules where its segments cross,
+ * in which case a search over the tiles should be used instead.
+ **********************************************************************************************************************/
+bool fg_pfSearchHierarchical(int p_fromX, int p_fromY, int p_goalX, int p_goalY, c_pfNodeGrid &p_pfNodes,
+c_pfSearchStats &p_stats);
+
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The asynchronous pathfinding, which searches snapshots of the world on a pool of worker threads.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfJobs.hpp"
+    #include "pfLandmarks.hpp"
+
+    #include <condition_variable>
+    #include <deque>
+    #include <mutex>
+    #include <thread>
+    #include <vector>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+vector<thread>          g_pfWorkers            {}; //!< The worker threads.
+mutex                   g_pfJobMutex           {}; //!< Guards the queue and the stopping flag.
+condition_variable      g_pfJobCondition       {}; //!< Wakes the workers when a task is queued or they should stop.
+deque<function<void()>> g_pfJobQueue           {}; //!< The tasks which haven't been started yet, oldest first.
+bool                    g_arePfWorkersStopping {}; //!< True if the workers should stop.
+
+/***********************************************************************************************************************
+ * @brief The loop of a worker thread, which runs the queued tasks until the workers are stopped.
+ **********************************************************************************************************************/
+void fg_runPfWorker()
+{
+    while (true)
+    {
+        function<void()> l_task {};
+
+        {
+            unique_lock l_lock {g_pfJobMutex};
+            g_pfJobCondition.wait(l_lock, [] {return g_arePfWorkersStopping || !g_pfJobQueue.empty();});
+
+            if (g_arePfWorkersStopping)
+                return;
+
+            l_task = move(g_pfJobQueue.front());
+            g_pfJobQueue.pop_front();
+        }
+
+        l_task();
+    }
+}
+
+}
+
+c_pfJob::c_pfJob(e_pfAlgorithm p_algorithm, shared_ptr<const c_worldSnapshot> p_world, int p_fromX, int p_fromY,
+int p_goalX, int p_goalY) :
+v_world {move(p_world)}, v_algorithm {p_algorithm}, v_fromX {p_fromX}, v_fromY {p_fromY}, v_goalX {p_goalX},
+v_goalY {p_goalY}
+{
+
+}
+
+void c_pfJob::f_run()
+{
+    if (!v_isCancelled.load(memory_order_relaxed))
+    {
+        c_pfNodeGrid &l_nodes {fg_getSharedPfNodeGrid()};
+
+        v_isFound =
+            fg_pfSearch(v_algorithm, v_world->f_getView(), v_fromX, v_fromY, v_goalX, v_goalY, l_nodes, v_stats);
+
+        if (v_isFound)
+            v_path.f_buildFromNodes(v_fromX, v_fromY, v_goalX, v_goalY, l_nodes);
+    }
+
+    // Publishes the results to the requester.
+    v_isDone.store(true, memory_order_release);
+}
+
+void c_pfJob::f_cancel()
+{
+    v_isCancelled.store(true, memory_order_relaxed);
+}
+
+bool c_pfJob::f_isCancelled() const
+{
+    return v_isCancelled.load(memory_order_relaxed);
+}
+
+bool c_pfJob::f_isDone() const
+{
+    return v_isDone.load(memory_order_acquire);
+}
+
+pair<int, int> c_pfJob::f_getFrom() const
+{
+    return {v_fromX, v_fromY};
+}
+
+pair<int, int> c_pfJob::f_getGoal() const
+{
+    return {v_goalX, v_goalY};
+}
+
+uint64_t c_pfJob::f_getWorldRevision() const
+{
+    return v_world->v_revision;
+}
+
+bool c_pfJob::f_isFound() const
+{
+    return v_isFound;
+}
+
+c_pfPath &c_pfJob::f_getPath()
+{
+    return v_path;
+}
+
+const c_pfSearchStats &c_pfJob::f_getStats() const
+{
+    return v_stats;
+}
+
+void fg_startPfWorkers(size_t p_count)
+{
+    g_arePfWorkersStopping = false;
+
+    for (size_t l_i {}; l_i != p_count; ++l_i)
+        g_pfWorkers.emplace_back(fg_runPfWorker);
+}
+
+void fg_stopPfWorkers()
+{
+    {
+        lock_guard l_lock {g_pfJobMutex};
+        g_arePfWorkersStopping = true;
+        g_pfJobQueue.clear();
+    }
+
+    g_pfJobCondition.notify_all();
+
+    for (thread &l_worker : g_pfWorkers)
+        l_worker.join();
+
+    g_pfWorkers.clear();
+}
+
+void fg_requestPfTask(function<void()> p_task)
+{
+    if (g_pfWorkers.empty())
+    {
+        p_task();
+        return;
+    }
+
+    {
+        lock_guard l_lock {g_pfJobMutex};
+        g_pfJobQueue.push_back(move(p_task));
+    }
+
+    g_pfJobCondition.notify_one();
+}
+
+shared_ptr<c_pfJob> fg_requestPfJob(e_pfAlgorithm p_algorithm, int p_fromX, int p_fromY, int p_goalX, int p_goalY)
+{
+    // The landmarks are only rebuilt on request, and the request has to come from the main thread.
+    if (p_algorithm == e_pfAlgorithm::ev_landmarks)
+        fg_updatePfLandmarks();
+
+    shared_ptr<c_pfJob> l_job
+    {make_shared<c_pfJob>(p_algorithm, fg_getWorldSnapshot(), p_fromX, p_fromY, p_goalX, p_goalY)};
+
+    fg_requestPfTask([l_job] {l_job->f_run();});
+    return l_job;
+}
+
+}
\ No newline at end of file
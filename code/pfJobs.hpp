@@ -0,0 +1,137 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The asynchronous pathfinding, which searches snapshots of the world on a pool of worker threads.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "pfPath.hpp"
+#include "pfSearch.hpp"
+#include "world.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+
+
+
+namespace n_tdg
+{
+
+/***********************************************************************************************************************
+ * @brief A search which is done on a worker thread. The requester polls it with @c f_isDone, and may read its results
+ * only after that has returned true. Until then, only @c f_cancel and the getters of the request may be called.
+ **********************************************************************************************************************/
+class c_pfJob
+{
+    private:
+
+    std::shared_ptr<const c_worldSnapshot> v_world;     //!< The snapshot which is searched.
+    e_pfAlgorithm                          v_algorithm; //!< The search algorithm.
+    int                                    v_fromX;     //!< The start's world-space tile X-position.
+    int                                    v_fromY;     //!< The start's world-space tile Y-position.
+    int                                    v_goalX;     //!< The goal's world-space tile X-position.
+    int                                    v_goalY;     //!< The goal's world-space tile Y-position.
+
+    c_pfPath          v_path        {}; //!< The found path.
+    c_pfSearchStats   v_stats       {}; //!< The search's statistics.
+    bool              v_isFound     {}; //!< True if the goal was found.
+    std::atomic<bool> v_isCancelled {}; //!< True if the requester no longer wants the results.
+    std::atomic<bool> v_isDone      {}; //!< True once the results have been written, or the job was skipped.
+
+    public:
+
+    /*******************************************************************************************************************
+     * @param p_algorithm The search algorithm.
+     * @param p_world The snapshot to search.
+     * @param p_fromX, p_fromY The start's world-space tile position.
+     * @param p_goalX, p_goalY The goal's world-space tile position.
+     ******************************************************************************************************************/
+    c_pfJob(e_pfAlgorithm p_algorithm, std::shared_ptr<const c_worldSnapshot> p_world, int p_fromX, int p_fromY,
+    int p_goalX, int p_goalY);
+
+    /*******************************************************************************************************************
+     * @brief Does the search, unless the job has been cancelled, and marks the job as done. Called by a worker.
+     ******************************************************************************************************************/
+    void f_run();
+
+    /*******************************************************************************************************************
+     * @brief Tells the workers that the results are no longer wanted. A job that hasn't been started yet is skipped.
+     ******************************************************************************************************************/
+    void f_cancel();
+
+    /*******************************************************************************************************************
+     * @return True if the job has been cancelled.
+     ******************************************************************************************************************/
+    bool f_isCancelled() const;
+
+    /*******************************************************************************************************************
+     * @return True if the results can be read.
+     ******************************************************************************************************************/
+    bool f_isDone() const;
+
+    /*******************************************************************************************************************
+     * @return The start's world-space tile position.
+     ******************************************************************************************************************/
+    std::pair<int, int> f_getFrom() const;
+
+    /*******************************************************************************************************************
+     * @return The goal's world-space tile position.
+     ******************************************************************************************************************/
+    std::pair<int, int> f_getGoal() const;
+
+    /*******************************************************************************************************************
+     * @return The revision of the world that was searched.
+     ******************************************************************************************************************/
+    uint64_t f_getWorldRevision() const;
+
+    /*******************************************************************************************************************
+     * @return True if the goal was found. Only meaningful once the job is done.
+     ******************************************************************************************************************/
+    bool f_isFound() const;
+
+    /*******************************************************************************************************************
+     * @return The found path, which the requester may take by swapping. Only meaningful once the job is done.
+     ******************************************************************************************************************/
+    c_pfPath &f_getPath();
+
+    /*******************************************************************************************************************
+     * @return The search's statistics. Only meaningful once the job is done.
+     ******************************************************************************************************************/
+    const c_pfSearchStats &f_getStats() const;
+};
+
+/***********************************************************************************************************************
+ * @brief Starts the worker threads.
+ * @param p_count The number of workers.
+ **********************************************************************************************************************/
+void fg_startPfWorkers(size_t p_count);
+
+/***********************************************************************************************************************
+ * @brief Stops the worker threads after they've finished their current jobs. The jobs which are still queued are
+ * never done.
+ **********************************************************************************************************************/
+void fg_stopPfWorkers();
+
+/***********************************************************************************************************************
+ * @brief Queues a task to be run on a worker thread, such as rebuilding something derived from a snapshot of the
+ * world. If no workers have been started, the task is run before returning.
+ * @param p_task The task. Shouldn't touch the live world.
+ **********************************************************************************************************************/
+void fg_requestPfTask(std::function<void()> p_task);
+
+/***********************************************************************************************************************
+ * @brief Queues a search of the world's current revision. If no workers have been started, the search is done before
+ * returning. May only be called on the main thread.
+ * @param p_algorithm The search algorithm.
+ * @param p_fromX, p_fromY The start's world-space tile position.
+ * @param p_goalX, p_goalY The goal's world-space tile position.
+ * @return The job, which is shared with the workers until it's done.
+ **********************************************************************************************************************/
+std::shared_ptr<c_pfJob> fg_requestPfJob(e_pfAlgorithm p_algorithm, int p_fromX, int p_fromY, int p_goalX, int p_goalY);
+
+}
\ No newline at end of file
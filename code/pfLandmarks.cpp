@@ -0,0 +1,218 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of @c c_pfLandmarks.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfLandmarks.hpp"
+    #include "pfJobs.hpp"
+    #include "pfNodeGrid.hpp"
+
+    #include <mutex>
+
+    #include <SDL.h>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+mutex                           g_pfLandmarksMutex          {}; //!< Guards the latest landmarks and the queued flag.
+shared_ptr<const c_pfLandmarks> g_pfLandmarks               {}; //!< The latest landmarks that have been built.
+bool                            g_isPfLandmarkRebuildQueued {}; //!< True if a rebuild has been queued but not done.
+
+thread_local vector<pair<int, int>> g_pfLandmarkWavefront {}; //!< The breadth-first search's queue of tiles.
+
+}
+
+// Private members.
+#if 1
+
+    void c_pfLandmarks::f_spreadDistances(const c_worldView &p_world, size_t p_landmark)
+    {
+        using enum e_pfNodeDir;
+
+        auto [l_landmarkX, l_landmarkY] {v_positions[p_landmark]};
+
+        g_pfLandmarkWavefront.clear();
+        g_pfLandmarkWavefront.emplace_back(l_landmarkX, l_landmarkY);
+        v_distances[fs_getDistanceIndex(l_landmarkX, l_landmarkY) + p_landmark] = 0u;
+
+        // The queue only grows, so it's read by index instead of popping.
+        for (size_t l_index {}; l_index < g_pfLandmarkWavefront.size(); ++l_index)
+        {
+            auto [l_fromX, l_fromY] {g_pfLandmarkWavefront[l_index]};
+            uint16_t l_distance {v_distances[fs_getDistanceIndex(l_fromX, l_fromY) + p_landmark]};
+
+            for (e_pfNodeDir l_dir : {ev_right, ev_down, ev_left, ev_up})
+            {
+                auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dir)};
+                int l_x {l_fromX + l_offsetX};
+                int l_y {l_fromY + l_offsetY};
+
+                if (!p_world.f_isFree(l_x, l_y))
+                    continue;
+
+                uint16_t &l_newDistance {v_distances[fs_getDistanceIndex(l_x, l_y) + p_landmark]};
+
+                if (l_newDistance != g_pfNoLandmarkDistance)
+                    continue;
+
+                l_newDistance = static_cast<uint16_t>(l_distance + 1u);
+                g_pfLandmarkWavefront.emplace_back(l_x, l_y);
+            }
+        }
+    }
+
+#endif
+
+c_pfLandmarks::c_pfLandmarks(const c_worldView &p_world)
+{
+    uint64_t l_startTime {SDL_GetPerformanceCounter()};
+
+    v_distances.assign(static_cast<size_t>(g_worldW) * static_cast<size_t>(g_worldH) * g_pfLandmarkCount,
+    g_pfNoLandmarkDistance);
+
+    // Counts the regions' tiles, to find the largest region.
+    vector<size_t>         l_regionSizes      {};
+    vector<pair<int, int>> l_regionFirstTiles {};
+
+    for (int l_x {}; l_x < g_worldW; ++l_x)
+    {
+        for (int l_y {}; l_y < g_worldH; ++l_y)
+        {
+            uint16_t l_region {p_world.f_getRegion(l_x, l_y)};
+
+            if (l_region == g_noWorldRegion)
+                continue;
+
+            if (l_region >= l_regionSizes.size())
+            {
+                l_regionSizes.resize(l_region + 1u);
+                l_regionFirstTiles.resize(l_region + 1u);
+            }
+
+            if (l_regionSizes[l_region]++ == 0u)
+                l_regionFirstTiles[l_region] = {l_x, l_y};
+        }
+    }
+
+    if (!l_regionSizes.empty())
+    {
+        size_t l_largestRegion
+        {static_cast<size_t>(max_element(l_regionSizes.begin(), l_regionSizes.end()) - l_regionSizes.begin())};
+
+        // The first landmark is the tile furthest from the region's first tile, which is the last one that a search
+        // from there reaches. The search's distances are thrown away.
+        v_positions.push_back(l_regionFirstTiles[l_largestRegion]);
+        f_spreadDistances(p_world, 0u);
+        v_positions[0] = g_pfLandmarkWavefront.back();
+
+        for (const pair<int, int> &l_tile : g_pfLandmarkWavefront)
+            v_distances[fs_getDistanceIndex(l_tile.first, l_tile.second)] = g_pfNoLandmarkDistance;
+
+        // Every tile's distance to the nearest landmark so far.
+        vector<uint16_t> l_nearestDistances
+        (static_cast<size_t>(g_worldW) * static_cast<size_t>(g_worldH), g_pfNoLandmarkDistance);
+
+        for (size_t l_landmark {}; l_landmark < v_positions.size(); ++l_landmark)
+        {
+            f_spreadDistances(p_world, l_landmark);
+
+            pair<int, int> l_furthestTile     {};
+            uint16_t       l_furthestDistance {};
+
+            for (const pair<int, int> &l_tile : g_pfLandmarkWavefront)
+            {
+                size_t    l_distanceIndex {fs_getDistanceIndex(l_tile.first, l_tile.second)};
+                uint16_t &l_nearest       {l_nearestDistances[l_distanceIndex / g_pfLandmarkCount]};
+
+                l_nearest = min(l_nearest, v_distances[l_distanceIndex + l_landmark]);
+
+                if (l_nearest > l_furthestDistance)
+                {
+                    l_furthestTile     = l_tile;
+                    l_furthestDistance = l_nearest;
+                }
+            }
+
+            // Stops early if every tile of the region is a landmark.
+            if (v_positions.size() < g_pfLandmarkCount && l_furthestDistance != 0u)
+                v_positions.push_back(l_furthestTile);
+        }
+    }
+
+    v_stats.v_landmarkCount     = v_positions.size();
+    v_stats.v_memoryBytes       = v_distances.size() * sizeof(uint16_t) + v_positions.size() * sizeof(pair<int, int>);
+    v_stats.v_buildMicroseconds =
+    (SDL_GetPerformanceCounter() - l_startTime) * 1'000'000u / SDL_GetPerformanceFrequency();
+    v_stats.v_worldRevision     = p_world.f_getRevision();
+}
+
+uint64_t c_pfLandmarks::f_getWorldRevision() const
+{
+    return v_stats.v_worldRevision;
+}
+
+const c_pfLandmarkStats &c_pfLandmarks::f_getStats() const
+{
+    return v_stats;
+}
+
+const vector<pair<int, int>> &c_pfLandmarks::f_getPositions() const
+{
+    return v_positions;
+}
+
+void c_pfLandmarks::f_getDistances(int p_x, int p_y, t_pfLandmarkDistances &p_distances) const
+{
+    const uint16_t *l_distances {&v_distances[fs_getDistanceIndex(p_x, p_y)]};
+    copy(l_distances, l_distances + g_pfLandmarkCount, p_distances.begin());
+}
+
+shared_ptr<const c_pfLandmarks> fg_getPfLandmarks()
+{
+    lock_guard l_lock {g_pfLandmarksMutex};
+    return g_pfLandmarks;
+}
+
+void fg_updatePfLandmarks()
+{
+    uint64_t l_revision {fg_getWorldRevision()};
+
+    {
+        lock_guard l_lock {g_pfLandmarksMutex};
+
+        bool l_isUpToDate {g_pfLandmarks && g_pfLandmarks->f_getWorldRevision() == l_revision};
+
+        // A queued rebuild of an older revision is let finish, and the next update queues another one. Edits often
+        // come several per frame, so this keeps the workers from rebuilding every one of them.
+        if (l_isUpToDate || g_isPfLandmarkRebuildQueued)
+            return;
+
+        g_isPfLandmarkRebuildQueued = true;
+    }
+
+    fg_requestPfTask
+    (
+        [l_snapshot {fg_getWorldSnapshot()}]
+        {
+            shared_ptr<const c_pfLandmarks> l_landmarks {make_shared<const c_pfLandmarks>(l_snapshot->f_getView())};
+
+            lock_guard l_lock {g_pfLandmarksMutex};
+            g_pfLandmarks               = move(l_landmarks);
+            g_isPfLandmarkRebuildQueued = false;
+        }
+    );
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The landmarks of the pathfinding, whose distance tables give a tighter heuristic than the Manhattan distance.
+ * @details A few landmark tiles are picked far apart from each other, and the steps from every landmark to every tile
+ * are counted with a breadth-first search. By the triangle inequality, a path from a tile to the goal takes at least
+ * as many steps as the difference between their distances to any landmark. In mazes, where the Manhattan distance
+ * ignores every wall, the difference is much closer to the true distance.
+ *
+ * The distances don't follow the health rules, which only ever forbid steps, so the heuristic stays admissible. Like
+ * the Manhattan distance, it changes by at most 1 per step, so it's consistent too.
+ *
+ * The tables are rebuilt from a snapshot on a worker thread after the world changes, and until a rebuild is done the
+ * searches fall back to the Manhattan distance. Tables of an older revision could overestimate near an edit.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "world.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+constexpr size_t   g_pfLandmarkCount      {8u};         //!< The most landmarks that are picked.
+constexpr uint16_t g_pfNoLandmarkDistance {UINT16_MAX}; //!< The distance of a tile that a landmark can't reach.
+
+using t_pfLandmarkDistances = std::array<uint16_t, g_pfLandmarkCount>; //!< A tile's distance to every landmark.
+
+/***********************************************************************************************************************
+ * @brief The statistics of a build of the landmarks' tables.
+ **********************************************************************************************************************/
+class c_pfLandmarkStats
+{
+    public:
+
+    size_t   v_landmarkCount     {}; //!< The number of landmarks that were picked.
+    size_t   v_memoryBytes       {}; //!< The memory used by the distance tables.
+    uint64_t v_buildMicroseconds {}; //!< The build's wall-clock time, including picking the landmarks.
+    uint64_t v_worldRevision     {}; //!< The world's revision that the tables were built at.
+};
+
+/***********************************************************************************************************************
+ * @brief The landmarks and their distance tables at a revision of the world. Immutable once built, so it can be read
+ * from any thread.
+ **********************************************************************************************************************/
+class c_pfLandmarks
+{
+    private:
+
+    std::vector<std::pair<int, int>> v_positions {}; //!< The landmarks' world-space tile positions.
+    std::vector<uint16_t>            v_distances {}; //!< The distances, @c g_pfLandmarkCount per tile, column-major.
+    c_pfLandmarkStats                v_stats     {}; //!< The statistics of the build.
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return The index of the tile's first distance in @c v_distances.
+     ******************************************************************************************************************/
+    static size_t fs_getDistanceIndex(int p_x, int p_y);
+
+    /*******************************************************************************************************************
+     * @brief Counts the steps from a landmark to every tile with a breadth-first search.
+     * @param p_world The world which is searched.
+     * @param p_landmark The landmark's index.
+     ******************************************************************************************************************/
+    void f_spreadDistances(const c_worldView &p_world, size_t p_landmark);
+
+    public:
+
+    /*******************************************************************************************************************
+     * @brief Picks the landmarks and builds their tables. The landmarks are picked in the largest region, since the
+     * other regions can't be reached from it. The first one is the tile furthest from the region's first tile, and
+     * every next one is the tile furthest from the landmarks picked so far.
+     * @param p_world The world which is searched.
+     ******************************************************************************************************************/
+    explicit c_pfLandmarks(const c_worldView &p_world);
+
+    /*******************************************************************************************************************
+     * @return The world's revision that the tables were built at.
+     ******************************************************************************************************************/
+    uint64_t f_getWorldRevision() const;
+
+    /*******************************************************************************************************************
+     * @return The statistics of the build.
+     ******************************************************************************************************************/
+    const c_pfLandmarkStats &f_getStats() const;
+
+    /*******************************************************************************************************************
+     * @return The landmarks' world-space tile positions.
+     ******************************************************************************************************************/
+    const std::vector<std::pair<int, int>> &f_getPositions() const;
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @param p_distances Gets the tile's distance to every landmark. @c g_pfNoLandmarkDistance for the landmarks that
+     * can't reach the tile, and for the unused landmarks.
+     ******************************************************************************************************************/
+    void f_getDistances(int p_x, int p_y, t_pfLandmarkDistances &p_distances) const;
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @param p_goalDistances The goal's distances, from @c f_getDistances.
+     * @return The fewest steps that a path from the tile to the goal can take, according to the landmarks.
+     ******************************************************************************************************************/
+    uint32_t f_getHeuristic(int p_x, int p_y, const t_pfLandmarkDistances &p_goalDistances) const;
+};
+
+/***********************************************************************************************************************
+ * @return The latest landmarks that have been built, or null if none have. Their revision may be older than the
+ * world's. May be called on any thread.
+ **********************************************************************************************************************/
+std::shared_ptr<const c_pfLandmarks> fg_getPfLandmarks();
+
+/***********************************************************************************************************************
+ * @brief Queues a rebuild of the landmarks' tables with @c fg_requestPfTask if the world has changed since they were
+ * built, unless a rebuild is already queued. Called by the landmark searches of the live world and by
+ * @c fg_requestPfJob, so this is only needed for choosing when the work is begun. May only be called on the main
+ * thread.
+ **********************************************************************************************************************/
+void fg_updatePfLandmarks();
+
+inline size_t c_pfLandmarks::fs_getDistanceIndex(int p_x, int p_y)
+{
+    return (static_cast<size_t>(p_x) * static_cast<size_t>(g_worldH) + static_cast<size_t>(p_y)) * g_pfLandmarkCount;
+}
+
+inline uint32_t c_pfLandmarks::f_getHeuristic(int p_x, int p_y, const t_pfLandmarkDistances &p_goalDistances) const
+{
+    const uint16_t *l_distances {&v_distances[fs_getDistanceIndex(p_x, p_y)]};
+    int             l_heuristic {};
+
+    for (size_t l_landmark {}; l_landmark < g_pfLandmarkCount; ++l_landmark)
+    {
+        if (l_distances[l_landmark] == g_pfNoLandmarkDistance || p_goalDistances[l_landmark] == g_pfNoLandmarkDistance)
+            continue;
+
+        l_heuristic = std::max(l_heuristic, std::abs(p_goalDistances[l_landmark] - l_distances[l_landmark]));
+    }
+
+    return static_cast<uint32_t>(l_heuristic);
+}
+
+}
\ No newline at end of file
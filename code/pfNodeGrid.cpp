@@ -0,0 +1,99 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of @c c_pfNodeGrid.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfNodeGrid.hpp"
+
+    #include <algorithm>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+pair<int, int> fg_pfDirToOffset(e_pfNodeDir p_dir)
+{
+    switch (p_dir)
+    {
+        case e_pfNodeDir::ev_right: return { 1,  0};
+        case e_pfNodeDir::ev_down:  return { 0,  1};
+        case e_pfNodeDir::ev_left:  return {-1,  0};
+        case e_pfNodeDir::ev_up:    return { 0, -1};
+        default:                    return { 1,  0};
+    }
+}
+
+e_pfNodeDir fg_pfOffsetToDir(int p_offsetX, int p_offsetY)
+{
+    if (p_offsetX ==  1 && p_offsetY ==  0) return e_pfNodeDir::ev_right;
+    if (p_offsetX ==  0 && p_offsetY ==  1) return e_pfNodeDir::ev_down;
+    if (p_offsetX == -1 && p_offsetY ==  0) return e_pfNodeDir::ev_left;
+    if (p_offsetX ==  0 && p_offsetY == -1) return e_pfNodeDir::ev_up;
+    return e_pfNodeDir::ev_right;
+}
+
+e_pfNodeDir fg_pfReverseDir(e_pfNodeDir p_dir)
+{
+    switch (p_dir)
+    {
+        case e_pfNodeDir::ev_right: return e_pfNodeDir::ev_left;
+        case e_pfNodeDir::ev_down:  return e_pfNodeDir::ev_up;
+        case e_pfNodeDir::ev_left:  return e_pfNodeDir::ev_right;
+        case e_pfNodeDir::ev_up:    return e_pfNodeDir::ev_down;
+        default:                    return e_pfNodeDir::ev_right;
+    }
+}
+
+// Public members.
+#if 1
+
+    size_t c_pfNodeGrid::fs_getIndex(int p_x, int p_y)
+    {
+        return static_cast<size_t>(p_x) * static_cast<size_t>(g_worldH) + static_cast<size_t>(p_y);
+    }
+
+    c_pfNodeGrid::c_pfNodeGrid() : v_nodes(static_cast<size_t>(g_worldW) * static_cast<size_t>(g_worldH))
+    {
+
+    }
+
+    void c_pfNodeGrid::f_beginSearch()
+    {
+        ++v_searchId;
+
+        // The search ID wrapped around, so the stale stamps could be mistaken for the current search's stamps.
+        if (v_searchId == 0u)
+        {
+            fill(v_nodes.begin(), v_nodes.end(), c_pfNode {});
+            v_searchId = 1u;
+        }
+    }
+
+    bool c_pfNodeGrid::f_isVisited(int p_x, int p_y) const
+    {
+        return v_nodes[fs_getIndex(p_x, p_y)].v_searchId == v_searchId;
+    }
+
+    c_pfNode &c_pfNodeGrid::f_visit(int p_x, int p_y)
+    {
+        c_pfNode &l_node {v_nodes[fs_getIndex(p_x, p_y)]};
+        l_node.v_searchId = v_searchId;
+        return l_node;
+    }
+
+    const c_pfNode &c_pfNodeGrid::f_getNode(int p_x, int p_y) const
+    {
+        return v_nodes[fs_getIndex(p_x, p_y)];
+    }
+
+#endif
+
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The header file of @c c_pfNodeGrid, the reusable node store of the pathfinding.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "main.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+//! A direction between two neighbouring tiles. Fits in 2 bits.
+enum class e_pfNodeDir : unsigned char {ev_right, ev_down, ev_left, ev_up};
+
+/***********************************************************************************************************************
+ * @param p_dir The direction.
+ * @return The tile offset of the given direction.
+ **********************************************************************************************************************/
+std::pair<int, int> fg_pfDirToOffset(e_pfNodeDir p_dir);
+
+/***********************************************************************************************************************
+ * @param p_offsetX, p_offsetY The tile offset. Must be one of the four neighbouring offsets.
+ * @return The direction of the given tile offset. @c e_pfNodeDir::ev_right for an invalid offset.
+ **********************************************************************************************************************/
+e_pfNodeDir fg_pfOffsetToDir(int p_offsetX, int p_offsetY);
+
+/***********************************************************************************************************************
+ * @param p_dir The direction.
+ * @return The opposite direction of the given direction.
+ **********************************************************************************************************************/
+e_pfNodeDir fg_pfReverseDir(e_pfNodeDir p_dir);
+
+/***********************************************************************************************************************
+ * @brief A pathfinding node of a single tile. Kept at 4 bytes so that a whole world's worth of nodes stays compact.
+ **********************************************************************************************************************/
+class c_pfNode
+{
+    public:
+
+    uint16_t      v_searchId {}; //!< The search which last visited the node. @sa c_pfNodeGrid::f_beginSearch
+    unsigned char v_health   {}; //!< The health of the node. A node with 0 health is not spread further.
+    e_pfNodeDir   v_dir      {}; //!< The direction towards the node which this node was spread from.
+};
+
+/***********************************************************************************************************************
+ * @brief A contiguous world-sized grid of pathfinding nodes, which is allocated once and reused by every search.
+ * Every search gets a new search ID, and a node counts as visited only if it's stamped with the current search ID.
+ * This way the grid never has to be cleared between searches, except when the search ID wraps around.
+ **********************************************************************************************************************/
+class c_pfNodeGrid
+{
+    private:
+
+    std::vector<c_pfNode> v_nodes    {}; //!< The nodes, indexed with @c fs_getIndex.
+    uint16_t              v_searchId {}; //!< The ID of the current search. 0 is never a valid search ID.
+
+    public:
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return The index of the tile's node. Matches the memory layout of @c g_staticObjs, so it can also index
+     * per-tile data which is kept alongside the grid.
+     ******************************************************************************************************************/
+    static size_t fs_getIndex(int p_x, int p_y);
+
+    /*******************************************************************************************************************
+     * @brief Creates a grid which covers the whole world. This is the only allocation the grid does.
+     ******************************************************************************************************************/
+    c_pfNodeGrid();
+
+    /*******************************************************************************************************************
+     * @brief Starts a new search, which makes every node unvisited.
+     ******************************************************************************************************************/
+    void f_beginSearch();
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return True if the tile's node has been visited during the current search.
+     ******************************************************************************************************************/
+    bool f_isVisited(int p_x, int p_y) const;
+
+    /*******************************************************************************************************************
+     * @brief Marks the tile's node as visited during the current search.
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return The tile's node. Its health and direction are left as they were.
+     ******************************************************************************************************************/
+    c_pfNode &f_visit(int p_x, int p_y);
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return The tile's node. Only meaningful if @c f_isVisited returns true for the tile.
+     ******************************************************************************************************************/
+    const c_pfNode &f_getNode(int p_x, int p_y) const;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of @c c_pfPath.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfPath.hpp"
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+void c_pfPath::f_clear()
+{
+    v_packedSteps.clear();
+    v_length = 0u;
+    v_cursor = 0u;
+}
+
+void c_pfPath::f_resize(size_t p_length)
+{
+    v_packedSteps.resize((p_length + 3u) / 4u);
+    v_length = p_length;
+    v_cursor = 0u;
+}
+
+void c_pfPath::f_buildFromNodes(int p_fromX, int p_fromY, int p_goalX, int p_goalY, const c_pfNodeGrid &p_pfNodes)
+{
+    // Counts the steps by backtracking from the goal to the start, so that the steps can then be written in order.
+
+    size_t l_length {};
+
+    for (int l_x {p_goalX}, l_y {p_goalY}; l_x != p_fromX || l_y != p_fromY; ++l_length)
+    {
+        auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(p_pfNodes.f_getNode(l_x, l_y).v_dir)};
+        l_x += l_offsetX;
+        l_y += l_offsetY;
+    }
+
+    f_resize(l_length);
+
+    // Writes the steps from the last one to the first one.
+
+    size_t l_index {l_length};
+
+    for (int l_x {p_goalX}, l_y {p_goalY}; l_x != p_fromX || l_y != p_fromY;)
+    {
+        e_pfNodeDir l_dirToPrev {p_pfNodes.f_getNode(l_x, l_y).v_dir};
+        auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dirToPrev)};
+        l_x += l_offsetX;
+        l_y += l_offsetY;
+
+        f_setStep(--l_index, fg_pfReverseDir(l_dirToPrev));
+    }
+}
+
+void c_pfPath::f_setStep(size_t p_index, e_pfNodeDir p_dir)
+{
+    unsigned char &l_byte  {v_packedSteps[p_index / 4u]};
+    unsigned int   l_shift {static_cast<unsigned int>(p_index % 4u) * 2u};
+
+    l_byte = static_cast<unsigned char>((l_byte & ~(3u << l_shift)) | (static_cast<unsigned int>(p_dir) << l_shift));
+}
+
+e_pfNodeDir c_pfPath::f_getStep(size_t p_index) const
+{
+    unsigned int l_shift {static_cast<unsigned int>(p_index % 4u) * 2u};
+    return static_cast<e_pfNodeDir>((v_packedSteps[p_index / 4u] >> l_shift) & 3u);
+}
+
+size_t c_pfPath::f_getLength() const
+{
+    return v_length;
+}
+
+size_t c_pfPath::f_getCursor() const
+{
+    return v_cursor;
+}
+
+size_t c_pfPath::f_getRemainingLength() const
+{
+    return v_length - v_cursor;
+}
+
+e_pfNodeDir c_pfPath::f_getNextStep() const
+{
+    return f_getStep(v_cursor);
+}
+
+void c_pfPath::f_advance()
+{
+    ++v_cursor;
+}
+
+}
\ No newline at end of file
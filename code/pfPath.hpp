@@ -0,0 +1,91 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The header file of @c c_pfPath.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "pfNodeGrid.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+/***********************************************************************************************************************
+ * @brief A path as a sequence of steps, packed as 2-bit directions, and a cursor to the next step to take. The memory
+ * use scales with the path's length instead of the world's size, and the storage is reused when the path is rebuilt.
+ **********************************************************************************************************************/
+class c_pfPath
+{
+    private:
+
+    std::vector<unsigned char> v_packedSteps {}; //!< The steps, 4 per byte, the first step in the lowest bits.
+    size_t                     v_length      {}; //!< The number of steps.
+    size_t                     v_cursor      {}; //!< The index of the next step to take.
+
+    public:
+
+    /*******************************************************************************************************************
+     * @brief Removes every step. Keeps the storage for reuse.
+     ******************************************************************************************************************/
+    void f_clear();
+
+    /*******************************************************************************************************************
+     * @brief Sets the number of steps and moves the cursor to the first step. The steps' directions are unspecified
+     * until they are set with @c f_setStep.
+     * @param p_length The new number of steps.
+     ******************************************************************************************************************/
+    void f_resize(size_t p_length);
+
+    /*******************************************************************************************************************
+     * @brief Replaces the steps with the path of a search, by backtracking from the goal to the start.
+     * @param p_fromX, p_fromY The start's world-space tile position.
+     * @param p_goalX, p_goalY The goal's world-space tile position. Must have been found by the search.
+     * @param p_pfNodes The nodes of the search.
+     ******************************************************************************************************************/
+    void f_buildFromNodes(int p_fromX, int p_fromY, int p_goalX, int p_goalY, const c_pfNodeGrid &p_pfNodes);
+
+    /*******************************************************************************************************************
+     * @param p_index The index of the step. Must be < @c f_getLength().
+     * @param p_dir The new direction of the step.
+     ******************************************************************************************************************/
+    void f_setStep(size_t p_index, e_pfNodeDir p_dir);
+
+    /*******************************************************************************************************************
+     * @param p_index The index of the step. Must be < @c f_getLength().
+     * @return The direction of the step.
+     ******************************************************************************************************************/
+    e_pfNodeDir f_getStep(size_t p_index) const;
+
+    /*******************************************************************************************************************
+     * @return The number of steps, including the already taken ones.
+     ******************************************************************************************************************/
+    size_t f_getLength() const;
+
+    /*******************************************************************************************************************
+     * @return The index of the next step to take.
+     ******************************************************************************************************************/
+    size_t f_getCursor() const;
+
+    /*******************************************************************************************************************
+     * @return The number of steps which have not been taken yet.
+     ******************************************************************************************************************/
+    size_t f_getRemainingLength() const;
+
+    /*******************************************************************************************************************
+     * @return The direction of the next step to take. Must not be called if @c f_getRemainingLength() is 0.
+     ******************************************************************************************************************/
+    e_pfNodeDir f_getNextStep() const;
+
+    /*******************************************************************************************************************
+     * @brief Moves the cursor to the next step. Must not be called if @c f_getRemainingLength() is 0.
+     ******************************************************************************************************************/
+    void f_advance();
+};
+
+}
\ No newline at end of file
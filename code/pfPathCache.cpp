@@ -0,0 +1,153 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of @c c_pfPathCache.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfPathCache.hpp"
+
+    #include <functional>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+constexpr size_t g_pfPathCacheDefaultCapacity {256u}; //!< The shared cache's capacity.
+
+c_pfPathCache g_pfPathCache {g_pfPathCacheDefaultCapacity}; //!< The cache shared by every character.
+
+}
+
+double c_pfPathCacheStats::f_getHitRate() const
+{
+    uint64_t l_lookups {v_hits + v_misses};
+    return l_lookups == 0u ? 0.0 : static_cast<double>(v_hits) / static_cast<double>(l_lookups);
+}
+
+// Private members.
+#if 1
+
+    size_t c_pfPathCache::c_keyHash::operator()(const c_pfPathCacheKey &p_key) const
+    {
+        size_t l_hash {hash<uint64_t> {}(p_key.v_worldRevision)};
+
+        auto fl_combine = [&](int p_value)
+        {
+            l_hash ^= hash<int> {}(p_value) + 0x9e3779b97f4a7c15u + (l_hash << 6) + (l_hash >> 2);
+        };
+
+        fl_combine(static_cast<int>(p_key.v_algorithm));
+        fl_combine(p_key.v_fromX);
+        fl_combine(p_key.v_fromY);
+        fl_combine(p_key.v_goalX);
+        fl_combine(p_key.v_goalY);
+
+        return l_hash;
+    }
+
+#endif
+
+// Public members.
+#if 1
+
+    c_pfPathCache::c_pfPathCache(size_t p_capacity) : v_capacity {p_capacity}
+    {
+
+    }
+
+    bool c_pfPathCache::f_find(const c_pfPathCacheKey &p_key, c_pfPath &p_path, bool &p_isFound)
+    {
+        auto l_it {v_index.find(p_key)};
+
+        if (l_it == v_index.end())
+        {
+            ++v_stats.v_misses;
+            return false;
+        }
+
+        ++v_stats.v_hits;
+
+        // Moves the entry to the front without reallocating it.
+        v_entries.splice(v_entries.begin(), v_entries, l_it->second);
+
+        p_path = l_it->second->v_path;
+        p_isFound = l_it->second->v_isFound;
+        return true;
+    }
+
+    void c_pfPathCache::f_insert(const c_pfPathCacheKey &p_key, const c_pfPath &p_path, bool p_isFound)
+    {
+        if (v_capacity == 0u)
+            return;
+
+        auto l_it {v_index.find(p_key)};
+
+        if (l_it != v_index.end())
+        {
+            v_entries.splice(v_entries.begin(), v_entries, l_it->second);
+        }
+        else
+        {
+            // Reuses the least recently used entry's memory when the cache is full.
+            if (v_entries.size() == v_capacity)
+            {
+                v_index.erase(v_entries.back().v_key);
+                v_entries.splice(v_entries.begin(), v_entries, prev(v_entries.end()));
+                ++v_stats.v_evictions;
+            }
+            else
+                v_entries.emplace_front();
+
+            v_index[p_key] = v_entries.begin();
+        }
+
+        c_entry &l_entry {v_entries.front()};
+        l_entry.v_key = p_key;
+        l_entry.v_isFound = p_isFound;
+
+        if (p_isFound)
+            l_entry.v_path = p_path;
+        else
+            l_entry.v_path.f_clear();
+    }
+
+    void c_pfPathCache::f_setCapacity(size_t p_capacity)
+    {
+        v_capacity = p_capacity;
+
+        while (v_entries.size() > v_capacity)
+        {
+            v_index.erase(v_entries.back().v_key);
+            v_entries.pop_back();
+            ++v_stats.v_evictions;
+        }
+    }
+
+    size_t c_pfPathCache::f_getSize() const
+    {
+        return v_entries.size();
+    }
+
+    const c_pfPathCacheStats &c_pfPathCache::f_getStats() const
+    {
+        return v_stats;
+    }
+
+#endif
+
+c_pfPathCache &fg_getPfPathCache()
+{
+    return g_pfPathCache;
+}
+
+}
\ No newline at end of file
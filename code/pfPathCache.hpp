@@ -0,0 +1,140 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The header file of @c c_pfPathCache.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "pfPath.hpp"
+#include "pfSearch.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+
+
+
+namespace n_tdg
+{
+
+/***********************************************************************************************************************
+ * @brief What a search's result depends on. A result is only reused for the same world revision, so an edit anywhere
+ * in the world makes the older results unreachable, and they age out of the cache.
+ **********************************************************************************************************************/
+class c_pfPathCacheKey
+{
+    public:
+
+    e_pfAlgorithm v_algorithm     {}; //!< The search algorithm.
+    int           v_fromX         {}; //!< The start's world-space tile X-position.
+    int           v_fromY         {}; //!< The start's world-space tile Y-position.
+    int           v_goalX         {}; //!< The goal's world-space tile X-position.
+    int           v_goalY         {}; //!< The goal's world-space tile Y-position.
+    uint64_t      v_worldRevision {}; //!< The world's revision that was searched.
+
+    bool operator==(const c_pfPathCacheKey &p_other) const = default;
+};
+
+/***********************************************************************************************************************
+ * @brief The counters of a @c c_pfPathCache, for sizing it.
+ **********************************************************************************************************************/
+class c_pfPathCacheStats
+{
+    public:
+
+    uint64_t v_hits      {}; //!< The number of lookups which found a result.
+    uint64_t v_misses    {}; //!< The number of lookups which didn't find a result.
+    uint64_t v_evictions {}; //!< The number of results which were dropped to make room for newer ones.
+
+    /*******************************************************************************************************************
+     * @return The share of lookups which found a result, from 0 to 1. 0 if there have been no lookups.
+     ******************************************************************************************************************/
+    double f_getHitRate() const;
+};
+
+/***********************************************************************************************************************
+ * @brief A bounded cache of search results, which drops the least recently used result when it's full. Failed
+ * searches are cached too, since a goal that can't be reached tends to be requested again.
+ **********************************************************************************************************************/
+class c_pfPathCache
+{
+    private:
+
+    /*******************************************************************************************************************
+     * @brief The hash of a @c c_pfPathCacheKey.
+     ******************************************************************************************************************/
+    class c_keyHash
+    {
+        public:
+
+        size_t operator()(const c_pfPathCacheKey &p_key) const;
+    };
+
+    /*******************************************************************************************************************
+     * @brief A cached search result.
+     ******************************************************************************************************************/
+    class c_entry
+    {
+        public:
+
+        c_pfPathCacheKey v_key     {}; //!< The key of the result.
+        c_pfPath         v_path    {}; //!< The found path, which is empty if the goal wasn't found.
+        bool             v_isFound {}; //!< True if the goal was found.
+    };
+
+    using t_entries = std::list<c_entry>; //!< A list of entries, the most recently used first.
+
+    t_entries                                                             v_entries  {}; //!< The entries.
+    std::unordered_map<c_pfPathCacheKey, t_entries::iterator, c_keyHash> v_index    {}; //!< The entries by key.
+    size_t                                                                v_capacity {}; //!< The maximum entry count.
+    c_pfPathCacheStats                                                    v_stats    {}; //!< The counters.
+
+    public:
+
+    /*******************************************************************************************************************
+     * @param p_capacity The maximum number of results to keep.
+     ******************************************************************************************************************/
+    explicit c_pfPathCache(size_t p_capacity);
+
+    /*******************************************************************************************************************
+     * @brief Looks up a result, and marks it as the most recently used one.
+     * @param p_key The key of the result.
+     * @param p_path Gets the result's path, with the cursor at the first step.
+     * @param p_isFound Gets whether the search found the goal.
+     * @return True if the result was cached. Otherwise the parameters are left as they were.
+     ******************************************************************************************************************/
+    bool f_find(const c_pfPathCacheKey &p_key, c_pfPath &p_path, bool &p_isFound);
+
+    /*******************************************************************************************************************
+     * @brief Adds or replaces a result. Evicts the least recently used result if the cache is full.
+     * @param p_key The key of the result.
+     * @param p_path The found path, with the cursor at the first step. Ignored if the goal wasn't found.
+     * @param p_isFound True if the search found the goal.
+     ******************************************************************************************************************/
+    void f_insert(const c_pfPathCacheKey &p_key, const c_pfPath &p_path, bool p_isFound);
+
+    /*******************************************************************************************************************
+     * @brief Sets the maximum number of results to keep, evicting the least recently used results if needed.
+     * @param p_capacity The new maximum.
+     ******************************************************************************************************************/
+    void f_setCapacity(size_t p_capacity);
+
+    /*******************************************************************************************************************
+     * @return The number of cached results.
+     ******************************************************************************************************************/
+    size_t f_getSize() const;
+
+    /*******************************************************************************************************************
+     * @return The counters since the cache's creation.
+     ******************************************************************************************************************/
+    const c_pfPathCacheStats &f_getStats() const;
+};
+
+/***********************************************************************************************************************
+ * @return The cache which is shared by every character. May only be used on the main thread.
+ **********************************************************************************************************************/
+c_pfPathCache &fg_getPfPathCache();
+
+}
\ No newline at end of file
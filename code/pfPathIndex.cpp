@@ -0,0 +1,126 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of @c c_pfPathIndex.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfPathIndex.hpp"
+    #include "pfNodeGrid.hpp"
+    #include "world.hpp"
+
+    #include <algorithm>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+c_pfPathIndex g_pfPathIndex {}; //!< The index which is shared by every character.
+
+}
+
+// Public members.
+#if 1
+
+    c_pfPathIndex::c_pfPathIndex() : v_steps(static_cast<size_t>(g_worldW) * static_cast<size_t>(g_worldH))
+    {
+
+    }
+
+    void c_pfPathIndex::f_insert(uint32_t p_agent, int p_fromX, int p_fromY, const c_pfPath &p_path)
+    {
+        f_erase(p_agent);
+
+        if (p_path.f_getRemainingLength() == 0u)
+            return;
+
+        vector<uint32_t> &l_tiles {v_tiles[p_agent]};
+
+        int l_x {p_fromX};
+        int l_y {p_fromY};
+
+        for (size_t l_step {p_path.f_getCursor()}; l_step != p_path.f_getLength(); ++l_step)
+        {
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(p_path.f_getStep(l_step))};
+            l_x += l_offsetX;
+            l_y += l_offsetY;
+
+            // A path that leaves the world is broken anyway, and checked on its next move.
+            if (!fg_isPosInWorldBounds(l_x, l_y))
+                break;
+
+            uint32_t l_tile {static_cast<uint32_t>(c_pfNodeGrid::fs_getIndex(l_x, l_y))};
+            v_steps[l_tile].push_back({p_agent, static_cast<uint32_t>(l_step), l_x, l_y});
+            l_tiles.push_back(l_tile);
+        }
+    }
+
+    void c_pfPathIndex::f_erase(uint32_t p_agent)
+    {
+        auto l_entry {v_tiles.find(p_agent)};
+
+        if (l_entry == v_tiles.end())
+            return;
+
+        // A tile that the path crosses more than once has the agent once per crossing, and one is removed per crossing.
+        for (uint32_t l_tile : l_entry->second)
+        {
+            vector<c_pfIndexedStep> &l_steps {v_steps[l_tile]};
+            auto                     l_step
+            {
+                find_if
+                (l_steps.begin(), l_steps.end(), [&](const c_pfIndexedStep &p_step) {return p_step.v_agent == p_agent;})
+            };
+
+            *l_step = l_steps.back();
+            l_steps.pop_back();
+        }
+
+        v_tiles.erase(l_entry);
+    }
+
+    void c_pfPathIndex::f_findSteps(int p_x, int p_y, vector<c_pfIndexedStep> &p_steps) const
+    {
+        if (g_staticObjs[p_x][p_y] != 0u)
+        {
+            const vector<c_pfIndexedStep> &l_steps {v_steps[c_pfNodeGrid::fs_getIndex(p_x, p_y)]};
+            p_steps.insert(p_steps.end(), l_steps.begin(), l_steps.end());
+            return;
+        }
+
+        // A neighbour with a static object isn't on a path, and one still near a wall keeps its health.
+        for (int l_x {max(p_x - 1, 0)}; l_x <= min(p_x + 1, g_worldW - 1); ++l_x)
+        {
+            for (int l_y {max(p_y - 1, 0)}; l_y <= min(p_y + 1, g_worldH - 1); ++l_y)
+            {
+                if (fg_isPosNearWall(l_x, l_y))
+                    continue;
+
+                const vector<c_pfIndexedStep> &l_steps {v_steps[c_pfNodeGrid::fs_getIndex(l_x, l_y)]};
+                p_steps.insert(p_steps.end(), l_steps.begin(), l_steps.end());
+            }
+        }
+    }
+
+    size_t c_pfPathIndex::f_getSize() const
+    {
+        return v_tiles.size();
+    }
+
+#endif
+
+c_pfPathIndex &fg_getPfPathIndex()
+{
+    return g_pfPathIndex;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The header file of @c c_pfPathIndex.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "pfPath.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+/***********************************************************************************************************************
+ * @brief A step of an indexed path, and the tile that it enters.
+ **********************************************************************************************************************/
+class c_pfIndexedStep
+{
+    public:
+
+    uint32_t v_agent {}; //!< The agent whose path the step is in.
+    uint32_t v_step  {}; //!< The step's index in the path.
+    int      v_x     {}; //!< The entered tile's world-space X-position.
+    int      v_y     {}; //!< The entered tile's world-space Y-position.
+
+    auto operator<=>(const c_pfIndexedStep &p_other) const = default;
+};
+
+/***********************************************************************************************************************
+ * @brief An index from every tile to the steps of the paths which enter it, so that a world edit only has to check
+ * the paths that it can break, and only around the steps that it can break.
+ * @details A path can be broken by adding a wall on one of its tiles, and by removing a wall next to one of its tiles,
+ * which can take away the tile's health. So an edit only looks up the tile if it now has a static object, and otherwise
+ * the neighbours that are no longer near a wall. Adding a wall next to a tile only gives it health.
+ *
+ * The tiles of a path stay indexed until the path is indexed again or erased, including the tiles that the agent has
+ * already passed. Those only add agents whose paths turn out to be intact.
+ **********************************************************************************************************************/
+class c_pfPathIndex
+{
+    private:
+
+    std::vector<std::vector<c_pfIndexedStep>>            v_steps {}; //!< The steps into every tile, by tile index.
+    std::unordered_map<uint32_t, std::vector<uint32_t>> v_tiles {}; //!< The indexed tiles of every agent.
+
+    public:
+
+    /*******************************************************************************************************************
+     * @brief Creates an index which covers the whole world.
+     ******************************************************************************************************************/
+    c_pfPathIndex();
+
+    /*******************************************************************************************************************
+     * @brief Indexes the rest of an agent's path, replacing its earlier path.
+     * @param p_agent The agent.
+     * @param p_fromX, p_fromY The world-space tile position where the path continues from.
+     * @param p_path The path, whose steps from the cursor are indexed.
+     ******************************************************************************************************************/
+    void f_insert(uint32_t p_agent, int p_fromX, int p_fromY, const c_pfPath &p_path);
+
+    /*******************************************************************************************************************
+     * @brief Removes an agent's path from the index, if it has one.
+     * @param p_agent The agent.
+     ******************************************************************************************************************/
+    void f_erase(uint32_t p_agent);
+
+    /*******************************************************************************************************************
+     * @brief Gets the steps which an edit of a tile can break, given the tile's current static object.
+     * @param p_x, p_y The edited tile's world-space position. Must be inside the world's boundaries.
+     * @param p_steps Gets the steps added to it.
+     ******************************************************************************************************************/
+    void f_findSteps(int p_x, int p_y, std::vector<c_pfIndexedStep> &p_steps) const;
+
+    /*******************************************************************************************************************
+     * @return The number of agents with an indexed path.
+     ******************************************************************************************************************/
+    size_t f_getSize() const;
+};
+
+/***********************************************************************************************************************
+ * @return The index which is shared by every character. May only be used on the main thread.
+ **********************************************************************************************************************/
+c_pfPathIndex &fg_getPfPathIndex();
+
+}
\ No newline at end of file
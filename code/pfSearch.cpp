@@ -0,0 +1,414 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The search algorithms of the pathfinding.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "pfSearch.hpp"
+    #include "pfBitWavefront.hpp"
+    #include "pfHierarchy.hpp"
+    #include "world.hpp"
+
+    #include <algorithm>
+    #include <cstdlib>
+
+    #include <SDL.h>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+// The searches' memory is per thread, so that searches of snapshots can run on several threads at once. The open set
+// keeps its memory between searches, so a search doesn't allocate.
+
+thread_local c_pfNodeGrid     g_pfNodes  {}; //!< The node store shared by every search.
+thread_local c_pfSlicedSearch g_pfSearch {}; //!< The open set of the searches that are done in one go.
+
+}
+
+// Private members.
+#if 1
+
+    /*******************************************************************************************************************
+     * The Manhattan distance is admissible despite the health rules, since they only ever forbid steps and never make
+     * one cheaper. The landmarks' bound is too, and the larger of the two is used when there are landmarks.
+     ******************************************************************************************************************/
+    uint32_t c_pfSlicedSearch::f_getHeuristic(int p_x, int p_y) const
+    {
+        uint32_t l_manhattan {static_cast<uint32_t>(abs(v_goalX - p_x) + abs(v_goalY - p_y))};
+        return v_landmarks ? max(l_manhattan, v_landmarks->f_getHeuristic(p_x, p_y, v_goalDistances)) : l_manhattan;
+    }
+
+    void c_pfSlicedSearch::f_push(int p_x, int p_y, uint32_t p_cost, unsigned char p_health)
+    {
+        size_t l_estimate {p_cost + f_getHeuristic(p_x, p_y)};
+
+        if (l_estimate >= v_openBuckets.size())
+            v_openBuckets.resize(l_estimate + 1u);
+
+        v_openBuckets[l_estimate].push_back({p_cost, p_x, p_y, p_health});
+        v_bucketEnd = max(v_bucketEnd, l_estimate + 1u);
+    }
+
+    /*******************************************************************************************************************
+     * The unguided breadth-first wavefront, which is the original algorithm.
+     ******************************************************************************************************************/
+    e_pfSearchState c_pfSlicedSearch::f_resumeWavefront(const c_worldView &p_world, c_pfNodeGrid &p_pfNodes,
+    size_t p_nodeBudget, c_pfSearchStats &p_stats)
+    {
+        // The start has no node, so its health is given instead.
+        if (!v_isStartSpread)
+        {
+            if (p_nodeBudget == 0u)
+                return e_pfSearchState::ev_searching;
+
+            --p_nodeBudget;
+            ++p_stats.v_expandedNodes;
+            v_isStartSpread = true;
+
+            if
+            (
+                fg_pfSpreadNodeToNeighbours
+                (v_fromX, v_fromY, g_pfNodeMaxHealth, v_goalX, v_goalY, p_world, p_pfNodes, v_newPositions)
+            )
+            {
+                return e_pfSearchState::ev_found;
+            }
+        }
+
+        while (true)
+        {
+            if (v_processableIndex == v_processablePositions.size())
+            {
+                v_processablePositions.swap(v_newPositions);
+                v_newPositions.clear();
+                v_processableIndex = 0u;
+
+                if (v_processablePositions.empty())
+                    return e_pfSearchState::ev_notFound;
+            }
+
+            if (p_nodeBudget == 0u)
+                return e_pfSearchState::ev_searching;
+
+            auto [l_x, l_y] {v_processablePositions[v_processableIndex++]};
+            int l_health {p_pfNodes.f_getNode(l_x, l_y).v_health};
+
+            --p_nodeBudget;
+            ++p_stats.v_expandedNodes;
+
+            if (fg_pfSpreadNodeToNeighbours(l_x, l_y, l_health, v_goalX, v_goalY, p_world, p_pfNodes, v_newPositions))
+                return e_pfSearchState::ev_found;
+        }
+    }
+
+    /*******************************************************************************************************************
+     * Like in the wavefront, a tile keeps the first node that reaches it with the lowest cost, and a node with 0
+     * health gives way to any node that can be spread further. Preferring the healthier of equally costly nodes would
+     * find slightly shorter paths around obstacles, but it reopens so many nodes that the search becomes slower than
+     * the wavefront.
+     ******************************************************************************************************************/
+    e_pfSearchState c_pfSlicedSearch::f_resumeAStar(const c_worldView &p_world, c_pfNodeGrid &p_pfNodes,
+    size_t p_nodeBudget, c_pfSearchStats &p_stats)
+    {
+        using enum e_pfNodeDir;
+
+        while (v_bucketIndex < v_bucketEnd)
+        {
+            vector<c_pfOpenEntry> &l_bucket {v_openBuckets[v_bucketIndex]};
+
+            if (l_bucket.empty())
+            {
+                ++v_bucketIndex;
+                continue;
+            }
+
+            // Popping the newest entry of a bucket prefers the nodes that are furthest along, since they're likely the
+            // closest to the goal.
+            c_pfOpenEntry   l_entry {l_bucket.back()};
+            const c_pfNode &l_node  {p_pfNodes.f_getNode(l_entry.v_x, l_entry.v_y)};
+
+            if
+            (
+                l_entry.v_cost != v_costs[c_pfNodeGrid::fs_getIndex(l_entry.v_x, l_entry.v_y)] ||
+                l_entry.v_health != l_node.v_health
+            )
+            {
+                l_bucket.pop_back();
+                continue; // The node has been replaced since pushing.
+            }
+
+            if (l_entry.v_x == v_goalX && l_entry.v_y == v_goalY)
+                return e_pfSearchState::ev_found;
+
+            // The entry is left in the list, so that the search continues from it when resumed.
+            if (p_nodeBudget == 0u)
+                return e_pfSearchState::ev_searching;
+
+            l_bucket.pop_back();
+            --p_nodeBudget;
+            ++p_stats.v_expandedNodes;
+
+            for (e_pfNodeDir l_dir : {ev_right, ev_down, ev_left, ev_up})
+            {
+                auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dir)};
+                int l_x {l_entry.v_x + l_offsetX};
+                int l_y {l_entry.v_y + l_offsetY};
+
+                if (!p_world.f_isFree(l_x, l_y))
+                    continue;
+
+                uint32_t  l_cost    {l_entry.v_cost + 1u};
+                int       l_health  {p_world.f_isPosNearWall(l_x, l_y) ? g_pfNodeMaxHealth : l_entry.v_health - 1};
+                uint32_t &l_oldCost {v_costs[c_pfNodeGrid::fs_getIndex(l_x, l_y)]};
+
+                // The nearest tile next to a wall is at least the clearance - 1 steps away. If the health runs out
+                // before that, and before the goal, every path through the node is a dead end, so the heuristic is
+                // infinite.
+                if
+                (
+                    p_world.f_getWallClearance(l_x, l_y) - 1 > l_health &&
+                    f_getHeuristic(l_x, l_y) > static_cast<uint32_t>(l_health)
+                )
+                {
+                    continue;
+                }
+
+                if (p_pfNodes.f_isVisited(l_x, l_y))
+                {
+                    int  l_oldHealth {p_pfNodes.f_getNode(l_x, l_y).v_health};
+                    bool l_isBetter
+                    {
+                        l_cost < l_oldCost ||
+                        (l_oldHealth == 0 && l_health != 0)
+                    };
+
+                    if (!l_isBetter)
+                        continue;
+                }
+
+                c_pfNode &l_newNode {p_pfNodes.f_visit(l_x, l_y)};
+                l_newNode.v_health = static_cast<unsigned char>(l_health);
+                l_newNode.v_dir = fg_pfReverseDir(l_dir);
+                l_oldCost = l_cost;
+
+                if (l_health != 0 || (l_x == v_goalX && l_y == v_goalY))
+                    f_push(l_x, l_y, l_cost, l_newNode.v_health);
+            }
+        }
+
+        return e_pfSearchState::ev_notFound;
+    }
+
+#endif
+
+// Public members.
+#if 1
+
+    void c_pfSlicedSearch::f_begin(e_pfAlgorithm p_algorithm, const c_worldView &p_world, int p_fromX, int p_fromY,
+    int p_goalX, int p_goalY, c_pfNodeGrid &p_pfNodes)
+    {
+        v_isAStar = p_algorithm != e_pfAlgorithm::ev_wavefront && p_algorithm != e_pfAlgorithm::ev_bitWavefront;
+        v_fromX = p_fromX;
+        v_fromY = p_fromY;
+        v_goalX = p_goalX;
+        v_goalY = p_goalY;
+        v_state = e_pfSearchState::ev_searching;
+        v_landmarks.reset();
+
+        p_pfNodes.f_beginSearch();
+
+        // A goal in another region would only be given up on after flooding everything that is reachable.
+        if (fg_isPosInWorldBounds(p_goalX, p_goalY) && p_world.f_isCutOff(p_fromX, p_fromY, p_goalX, p_goalY))
+        {
+            v_state = e_pfSearchState::ev_notFound;
+            return;
+        }
+
+        if (!v_isAStar)
+        {
+            v_isStartSpread = false;
+            v_processablePositions.clear();
+            v_newPositions.clear();
+            v_processableIndex = 0u;
+            return;
+        }
+
+        if (!fg_isPosInWorldBounds(p_goalX, p_goalY))
+        {
+            v_state = e_pfSearchState::ev_notFound;
+            return;
+        }
+
+        if (p_algorithm == e_pfAlgorithm::ev_landmarks)
+        {
+            if (p_world.f_isLive())
+                fg_updatePfLandmarks();
+
+            // Tables of another revision could overestimate near an edit.
+            v_landmarks = fg_getPfLandmarks();
+
+            if (v_landmarks && v_landmarks->f_getWorldRevision() != p_world.f_getRevision())
+                v_landmarks.reset();
+            else if (v_landmarks)
+                v_landmarks->f_getDistances(p_goalX, p_goalY, v_goalDistances);
+        }
+
+        if (v_costs.empty())
+            v_costs.resize(static_cast<size_t>(g_worldW) * static_cast<size_t>(g_worldH));
+
+        // An earlier search may have finished before emptying its buckets.
+        for (vector<c_pfOpenEntry> &l_bucket : v_openBuckets)
+            l_bucket.clear();
+
+        // Both heuristics are consistent, so no estimate is below the bucket which is being popped.
+        v_bucketIndex = f_getHeuristic(p_fromX, p_fromY);
+        v_bucketEnd = v_bucketIndex;
+
+        // The start node can't be replaced, since every other node costs more.
+        c_pfNode &l_startNode {p_pfNodes.f_visit(p_fromX, p_fromY)};
+        l_startNode.v_health = static_cast<unsigned char>(g_pfNodeMaxHealth);
+        v_costs[c_pfNodeGrid::fs_getIndex(p_fromX, p_fromY)] = 0u;
+        f_push(p_fromX, p_fromY, 0u, l_startNode.v_health);
+    }
+
+    e_pfSearchState c_pfSlicedSearch::f_resume(const c_worldView &p_world, c_pfNodeGrid &p_pfNodes,
+    size_t p_nodeBudget, c_pfSearchStats &p_stats)
+    {
+        if (v_state != e_pfSearchState::ev_searching)
+            return v_state;
+
+        v_state = v_isAStar ?
+        f_resumeAStar(p_world, p_pfNodes, p_nodeBudget, p_stats) :
+        f_resumeWavefront(p_world, p_pfNodes, p_nodeBudget, p_stats);
+
+        // A finished search doesn't keep the landmarks alive.
+        if (v_state != e_pfSearchState::ev_searching)
+            v_landmarks.reset();
+
+        return v_state;
+    }
+
+    e_pfSearchState c_pfSlicedSearch::f_getState() const
+    {
+        return v_state;
+    }
+
+    pair<int, int> c_pfSlicedSearch::f_getGoal() const
+    {
+        return {v_goalX, v_goalY};
+    }
+
+#endif
+
+c_pfNodeGrid &fg_getSharedPfNodeGrid()
+{
+    return g_pfNodes;
+}
+
+bool
+fg_pfSpreadNode(int p_fromX, int p_fromY, e_pfNodeDir p_dir, int p_creatorHealth, int p_goalX, int p_goalY,
+const c_worldView &p_world, c_pfNodeGrid &p_pfNodes, t_pfNodePositions &p_newPfNodePositions)
+{
+    auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(p_dir)};
+    int l_x {p_fromX + l_offsetX};
+    int l_y {p_fromY + l_offsetY};
+
+    if (!p_world.f_isFree(l_x, l_y))
+        return false;
+
+    if (p_pfNodes.f_isVisited(l_x, l_y) && p_pfNodes.f_getNode(l_x, l_y).v_health != 0u)
+        return false;
+
+    int       l_health {p_world.f_isPosNearWall(l_x, l_y) ? g_pfNodeMaxHealth : p_creatorHealth - 1};
+    c_pfNode &l_node   {p_pfNodes.f_visit(l_x, l_y)};
+    l_node.v_health = static_cast<unsigned char>(l_health);
+    l_node.v_dir = fg_pfReverseDir(p_dir);
+
+    if (l_node.v_health != 0u)
+        p_newPfNodePositions.push_back({l_x, l_y});
+
+    return l_x == p_goalX && l_y == p_goalY;
+}
+
+bool
+fg_pfSpreadNodeToNeighbours(int p_fromX, int p_fromY, int p_creatorHealth, int p_goalX, int p_goalY,
+const c_worldView &p_world, c_pfNodeGrid &p_pfNodes, t_pfNodePositions &p_newPfNodePositions)
+{
+    using enum e_pfNodeDir;
+
+    for (e_pfNodeDir l_dir : {ev_right, ev_down, ev_left, ev_up})
+    {
+        if
+        (
+            fg_pfSpreadNode
+            (p_fromX, p_fromY, l_dir, p_creatorHealth, p_goalX, p_goalY, p_world, p_pfNodes, p_newPfNodePositions)
+        )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool
+fg_pfSearch(e_pfAlgorithm p_algorithm, const c_worldView &p_world, int p_fromX, int p_fromY, int p_goalX, int p_goalY,
+c_pfNodeGrid &p_pfNodes, c_pfSearchStats &p_stats)
+{
+    uint64_t l_startTime {SDL_GetPerformanceCounter()};
+    bool     l_isFound   {};
+
+    p_stats = {};
+
+    // Every search is begun by the sliced search, which gives up on a goal in another region at once. The algorithms
+    // that it doesn't do search the nodes that it has begun.
+    g_pfSearch.f_begin(p_algorithm, p_world, p_fromX, p_fromY, p_goalX, p_goalY, p_pfNodes);
+
+    if (g_pfSearch.f_getState() == e_pfSearchState::ev_notFound)
+        return false;
+
+    switch (p_algorithm)
+    {
+        case e_pfAlgorithm::ev_wavefront:
+        case e_pfAlgorithm::ev_aStar:
+        case e_pfAlgorithm::ev_landmarks:
+            l_isFound = g_pfSearch.f_resume(p_world, p_pfNodes, SIZE_MAX, p_stats) == e_pfSearchState::ev_found;
+            break;
+
+        case e_pfAlgorithm::ev_hierarchical:
+            // The sliced search does the hierarchical search's fallback, which is the A*-search. It begins again after
+            // the hierarchical search, which has visited nodes.
+            if (p_world.f_isLive())
+            {
+                l_isFound = fg_pfSearchHierarchical(p_fromX, p_fromY, p_goalX, p_goalY, p_pfNodes, p_stats);
+
+                if (!l_isFound)
+                    g_pfSearch.f_begin(p_algorithm, p_world, p_fromX, p_fromY, p_goalX, p_goalY, p_pfNodes);
+            }
+
+            if (!l_isFound)
+                l_isFound = g_pfSearch.f_resume(p_world, p_pfNodes, SIZE_MAX, p_stats) == e_pfSearchState::ev_found;
+
+            break;
+
+        case e_pfAlgorithm::ev_bitWavefront:
+            l_isFound = fg_pfSearchBitWavefront(p_world, p_fromX, p_fromY, p_goalX, p_goalY, p_pfNodes, p_stats);
+            break;
+    }
+
+    p_stats.v_microseconds = (SDL_GetPerformanceCounter() - l_startTime) * 1'000'000u / SDL_GetPerformanceFrequency();
+    return l_isFound;
+}
+
+}
\ No newline at end of file
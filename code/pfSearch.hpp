@@ -0,0 +1,211 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The search algorithms of the pathfinding.
+ * @details Every algorithm follows the same health rules. A node next to a wall gets @c g_pfNodeMaxHealth health, and
+ * any other node gets 1 less health than the node it was spread from. A node with 0 health is not spread further, so
+ * only the goal may be reached with it. The start has the maximum health.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "pfLandmarks.hpp"
+#include "pfNodeGrid.hpp"
+#include "world.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+constexpr int    g_pfNodeMaxHealth     {15};    //!< The health of a start node and of a node next to a wall.
+constexpr size_t g_pfSlicedNodeBudget {8192u}; //!< The nodes that the sliced searches may expand per tick, together.
+
+using t_pfNodePositions = std::vector<std::pair<int, int>>; //!< A list of world-space tile positions.
+
+//! A search algorithm, for @c fg_pfSearch.
+enum class e_pfAlgorithm
+{
+    ev_wavefront,    //!< An unguided breadth-first wavefront, which is the original algorithm.
+    ev_aStar,        //!< A goal-directed A*-search with the Manhattan distance as the heuristic.
+    ev_hierarchical, //!< A search over clusters of tiles, refined into steps. Falls back to A* when it can't help,
+                     //!< and when searching a snapshot, since the clusters are only kept for the live world.
+    ev_bitWavefront, //!< The wavefront, spread 64 tiles at a time with bitwise operations. Faster than the original
+                     //!< wavefront, most of all in open areas. Can't flood without a goal.
+    ev_landmarks     //!< The A*-search with the landmarks' distance tables as the heuristic, which is much tighter in
+                     //!< mazes. Uses the Manhattan distance while the tables are older than the searched world.
+};
+
+/***********************************************************************************************************************
+ * @brief The statistics of a single search, for comparing the algorithms.
+ **********************************************************************************************************************/
+class c_pfSearchStats
+{
+    public:
+
+    size_t   v_expandedNodes {}; //!< The number of nodes which were spread to their neighbours.
+    uint64_t v_microseconds  {}; //!< The search's wall-clock time.
+};
+
+//! The state of a @c c_pfSlicedSearch.
+enum class e_pfSearchState
+{
+    ev_searching, //!< The search has been paused before finishing.
+    ev_found,     //!< The goal was found.
+    ev_notFound   //!< The search finished without finding the goal.
+};
+
+/***********************************************************************************************************************
+ * @brief An entry of the A*-search's open list. Stale entries are left in the list, and skipped when popped.
+ **********************************************************************************************************************/
+class c_pfOpenEntry
+{
+    public:
+
+    uint32_t      v_cost   {}; //!< The cost so far.
+    int           v_x      {}; //!< The world-space tile X-position.
+    int           v_y      {}; //!< The world-space tile Y-position.
+    unsigned char v_health {}; //!< The node's health at the time of pushing.
+};
+
+/***********************************************************************************************************************
+ * @brief A search which can be paused after expanding a number of nodes, and resumed later from where it was paused.
+ * This lets a large search be spread over several ticks. The open set is kept in the search between the calls, and
+ * the nodes in the node grid that is passed to every call.
+ * @details The wavefront and the A*-search are done this way, and the other algorithms with the nearest of the two.
+ * The bit-parallel wavefront is done with the wavefront, which finds paths of the same length, and the hierarchical
+ * search with the A*-search, which is what it falls back to.
+ **********************************************************************************************************************/
+class c_pfSlicedSearch
+{
+    private:
+
+    bool                                    v_isAStar              {}; //!< False for the wavefront.
+    int                                     v_fromX                {}; //!< The start's world-space tile X-position.
+    int                                     v_fromY                {}; //!< The start's world-space tile Y-position.
+    int                                     v_goalX                {}; //!< The goal's world-space tile X-position.
+    int                                     v_goalY                {}; //!< The goal's world-space tile Y-position.
+    e_pfSearchState                         v_state                {}; //!< The search's state.
+    std::shared_ptr<const c_pfLandmarks>    v_landmarks            {}; //!< The A*-search's landmarks, if any.
+    t_pfLandmarkDistances                   v_goalDistances        {}; //!< The goal's distances to the landmarks.
+    bool                                    v_isStartSpread        {}; //!< True once the wavefront's start is spread.
+    t_pfNodePositions                       v_processablePositions {}; //!< The wavefront which is being spread.
+    t_pfNodePositions                       v_newPositions         {}; //!< The wavefront which is being built.
+    size_t                                  v_processableIndex     {}; //!< The next node to spread of the wavefront.
+    std::vector<uint32_t>                   v_costs                {}; //!< The A*-search's cost so far of every node.
+    std::vector<std::vector<c_pfOpenEntry>> v_openBuckets          {}; //!< The A*-search's open list.
+    size_t                                  v_bucketIndex          {}; //!< The lowest bucket that may have entries.
+    size_t                                  v_bucketEnd            {}; //!< One past the highest such bucket.
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return The A*-search's estimate of the steps from the tile to the goal.
+     ******************************************************************************************************************/
+    uint32_t f_getHeuristic(int p_x, int p_y) const;
+
+    /*******************************************************************************************************************
+     * @brief Adds a node to the A*-search's open list.
+     ******************************************************************************************************************/
+    void f_push(int p_x, int p_y, uint32_t p_cost, unsigned char p_health);
+
+    /*******************************************************************************************************************
+     * @brief Resumes the wavefront. The parameters are as in @c f_resume.
+     ******************************************************************************************************************/
+    e_pfSearchState f_resumeWavefront(const c_worldView &p_world, c_pfNodeGrid &p_pfNodes, size_t p_nodeBudget,
+    c_pfSearchStats &p_stats);
+
+    /*******************************************************************************************************************
+     * @brief Resumes the A*-search. The parameters are as in @c f_resume.
+     ******************************************************************************************************************/
+    e_pfSearchState f_resumeAStar(const c_worldView &p_world, c_pfNodeGrid &p_pfNodes, size_t p_nodeBudget,
+    c_pfSearchStats &p_stats);
+
+    public:
+
+    /*******************************************************************************************************************
+     * @brief Begins a new search. Nothing is expanded until the search is resumed.
+     * @param p_algorithm The search algorithm.
+     * @param p_world The world which is searched. Must be the same world in every call until the search finishes.
+     * @param p_fromX, p_fromY The start's world-space tile position.
+     * @param p_goalX, p_goalY The goal's world-space tile position. Can be outside the world's boundaries, in which
+     * case the wavefront floods everything that is reachable, and the A*-search finds nothing.
+     * @param p_pfNodes The nodes of the search. A new search is begun in them.
+     ******************************************************************************************************************/
+    void f_begin(e_pfAlgorithm p_algorithm, const c_worldView &p_world, int p_fromX, int p_fromY, int p_goalX,
+    int p_goalY, c_pfNodeGrid &p_pfNodes);
+
+    /*******************************************************************************************************************
+     * @brief Expands nodes until the search finishes or the budget runs out.
+     * @param p_world The world which is searched.
+     * @param p_pfNodes The nodes of the search, which nothing else may have touched since the previous call.
+     * @param p_nodeBudget The most nodes to expand.
+     * @param p_stats Gets the number of expanded nodes added to it.
+     * @return The search's state. Once it's no longer @c ev_searching, the path can be backtracked from the goal by
+     * following the nodes' directions until the start.
+     ******************************************************************************************************************/
+    e_pfSearchState f_resume(const c_worldView &p_world, c_pfNodeGrid &p_pfNodes, size_t p_nodeBudget,
+    c_pfSearchStats &p_stats);
+
+    /*******************************************************************************************************************
+     * @return The search's state.
+     ******************************************************************************************************************/
+    e_pfSearchState f_getState() const;
+
+    /*******************************************************************************************************************
+     * @return The goal's world-space tile position.
+     ******************************************************************************************************************/
+    std::pair<int, int> f_getGoal() const;
+};
+
+/***********************************************************************************************************************
+ * @return The node grid which is shared by the searches of the calling thread that don't need to keep their nodes.
+ **********************************************************************************************************************/
+c_pfNodeGrid &fg_getSharedPfNodeGrid();
+
+/***********************************************************************************************************************
+ * @brief Spreads a node to a neighbouring tile, if the tile is free and its node hasn't been spread to yet.
+ * @param p_fromX, p_fromY The world-space tile position of the spreading node.
+ * @param p_dir The direction of the neighbouring tile.
+ * @param p_creatorHealth The health of the spreading node.
+ * @param p_goalX, p_goalY The goal's world-space tile position.
+ * @param p_world The world which is searched.
+ * @param p_pfNodes The nodes of the search.
+ * @param p_newPfNodePositions Gets the neighbouring tile's position if the new node can be spread further.
+ * @return True if the neighbouring tile is the goal and it was spread to.
+ **********************************************************************************************************************/
+bool
+fg_pfSpreadNode(int p_fromX, int p_fromY, e_pfNodeDir p_dir, int p_creatorHealth, int p_goalX, int p_goalY,
+const c_worldView &p_world, c_pfNodeGrid &p_pfNodes, t_pfNodePositions &p_newPfNodePositions);
+
+/***********************************************************************************************************************
+ * @brief Calls @c fg_pfSpreadNode for every direction, until the goal is found.
+ * @return True if the goal was spread to.
+ **********************************************************************************************************************/
+bool
+fg_pfSpreadNodeToNeighbours(int p_fromX, int p_fromY, int p_creatorHealth, int p_goalX, int p_goalY,
+const c_worldView &p_world, c_pfNodeGrid &p_pfNodes, t_pfNodePositions &p_newPfNodePositions);
+
+/***********************************************************************************************************************
+ * @brief Searches for a path with the given algorithm. The path can be backtracked from the goal by following the
+ * nodes' directions until the start.
+ * @param p_algorithm The search algorithm.
+ * @param p_world The world which is searched. Searches of a snapshot may run on any thread.
+ * @param p_fromX, p_fromY The start's world-space tile position.
+ * @param p_goalX, p_goalY The goal's world-space tile position. Can be outside the world's boundaries, in which case
+ * the wavefront floods everything that is reachable.
+ * @param p_pfNodes The nodes of the search. A new search is begun in them.
+ * @param p_stats Gets the search's statistics.
+ * @return True if the goal was found. False without searching if the goal is known to be cut off from the start.
+ * @sa c_worldView::f_isCutOff
+ **********************************************************************************************************************/
+bool
+fg_pfSearch(e_pfAlgorithm p_algorithm, const c_worldView &p_world, int p_fromX, int p_fromY, int p_goalX, int p_goalY,
+c_pfNodeGrid &p_pfNodes, c_pfSearchStats &p_stats);
+
+}
\ No newline at end of file
@@ -6,6 +6,11 @@
 #if 1
 
     #include "playerCharacter.hpp"
+    #include "entityGrid.hpp"
+    #include "moveScheduler.hpp"
+    #include "pfPathIndex.hpp"
+    #include "time.hpp"
+    #include "world.hpp"
 
     #include <algorithm>
     #include <array>
@@ -15,6 +20,7 @@
     #include <format>
     #include <fstream>
     #include <iostream>
+    #include <stdexcept>
     #include <string>
     #include <tuple>
     #include <unordered_map>
@@ -24,6 +30,7 @@
 
     using namespace std;
     using namespace n_tdg;
+    using namespace n_tdg::n_time;
 
 #endif
 
@@ -36,168 +43,738 @@ namespace n_tdg
 namespace
 {
 
-constexpr int g_nodeMaxHealth {15};
+constexpr int g_pfRepairRadius      {16}; //!< How far from a broken step a repair may search for a detour, in tiles.
+constexpr int g_pfRepairWindowW     {g_pfRepairRadius * 2 + 1}; //!< The width and height of a repair's search window.
+constexpr int g_pfMaxRepairAttempts {8};  //!< How many broken steps may be repaired before rebuilding instead.
+
+t_pfNodePositions g_pfRepairProcessablePositions {}; //!< The repair's wavefront which is being spread.
+t_pfNodePositions g_pfRepairNewPositions         {}; //!< The repair's wavefront which is being built.
+
+//! For each tile of a repair's search window, the path index where a detour may rejoin the path, or 0 if it may not.
+array<size_t, g_pfRepairWindowW * g_pfRepairWindowW> g_pfRepairTargets {};
+c_pfPath g_pfRepairedPath {}; //!< The repaired path which is being built. Swapped with the repaired character's path.
+
+uint32_t g_pfNextAgent {}; //!< The agent of the next character that is created. Identifies it in the tables.
+
+uint64_t          g_pfPathIndexRevision {}; //!< The world's revision that the indexed paths were last checked at.
+t_pfNodePositions       g_pfEditedTiles       {}; //!< The tiles edited since the paths were last checked.
+vector<c_pfIndexedStep> g_pfEditedSteps       {}; //!< The path steps which the edits may have broken.
+
+c_moveScheduler  g_moveScheduler     {}; //!< Wakes the characters whose moves are due.
+vector<uint32_t> g_dueAgents         {}; //!< The agents of the characters which were woken on the tick.
+vector<size_t>   g_characterIndices  {}; //!< The index of every agent's character in @c g_playerCharacters.
+
+c_entityGrid     g_characterGrid     {}; //!< The agents of the characters, by their positions.
+vector<uint32_t> g_foundAgents       {}; //!< The agents which were found in the grid.
+
+vector<c_playerCharacter *> g_pfSlicedSearchers  {}; //!< The characters whose sliced searches haven't finished.
+size_t                      g_pfSlicedSearchTurn {}; //!< Rotates which character's search is resumed first.
+
+//! How often every cooperative character plans again, in steps. Half the window, so the plans always overlap.
+constexpr uint64_t g_pfCooperativeRoundSteps {static_cast<uint64_t>(g_pfCooperativeWindow / 2)};
+
+c_pfReservationTable        g_pfReservations             {}; //!< The tiles that the cooperative characters reserved.
+vector<c_playerCharacter *> g_pfCooperativeAgents        {}; //!< The characters that plan cooperatively.
+size_t                      g_pfCooperativeTurn          {}; //!< Rotates which character plans first in a step.
+uint64_t                    g_pfNextCooperativeStepTime  {}; //!< When the cooperative characters take the next step.
+uint64_t                    g_pfCooperativeWorldRevision {}; //!< The world's revision at the latest round of plans.
+c_pfCooperativeStats        g_pfCooperativeStats         {}; //!< The statistics of the latest step.
+
+/***********************************************************************************************************************
+ * @param p_agent An agent.
+ * @return The agent's character, or a null pointer if it doesn't exist anymore.
+ **********************************************************************************************************************/
+c_playerCharacter *fg_findCharacter(uint32_t p_agent)
+{
+    auto fl_find = [&]() -> c_playerCharacter *
+    {
+        if (p_agent >= g_characterIndices.size() || g_characterIndices[p_agent] >= g_playerCharacters.size())
+            return nullptr;
+
+        c_playerCharacter &l_character {g_playerCharacters[g_characterIndices[p_agent]]};
+        return l_character.f_getAgent() == p_agent ? &l_character : nullptr;
+    };
+
+    if (c_playerCharacter *l_character {fl_find()})
+        return l_character;
+
+    // The characters have been added or removed since the indices were built.
+    g_characterIndices.clear();
+
+    for (size_t l_i {}; l_i != g_playerCharacters.size(); ++l_i)
+    {
+        uint32_t l_agent {g_playerCharacters[l_i].f_getAgent()};
+
+        if (l_agent >= g_characterIndices.size())
+            g_characterIndices.resize(static_cast<size_t>(l_agent) + 1u, SIZE_MAX);
+
+        g_characterIndices[l_agent] = l_i;
+    }
+
+    return fl_find();
+}
 
 }
 
 // Private members.
 #if 1
 
-    bool c_playerCharacter::fs_pfIsPosNearWall(int p_x, int p_y)
+    void c_playerCharacter::f_pfProcessNodesIntoPath(int p_goalX, int p_goalY, const c_pfNodeGrid &p_pfNodes)
     {
-        for (int l_x {p_x - 1}; l_x != p_x + 2; ++l_x)
-            for (int l_y {p_y - 1}; l_y != p_y + 2; ++l_y)
-            {
-                if (!fg_isPosInWorldBounds(l_x, l_y) || g_staticObjs[l_x][l_y] != 0u)
-                    return true;
-            }
-        
-        return false;
+        v_pfGoalX = p_goalX;
+        v_pfGoalY = p_goalY;
+
+        v_pfPath.f_buildFromNodes(v_posX, v_posY, p_goalX, p_goalY, p_pfNodes);
     }
 
-    pair<int, int> c_playerCharacter::fs_pfDirToOffset(e_pfNodeDir p_dir)
+    void c_playerCharacter::f_moveTo(int p_x, int p_y)
     {
-        switch (p_dir)
-        {
-            case e_pfNodeDir::ev_right: return { 1,  0};
-            case e_pfNodeDir::ev_down:  return { 0,  1};
-            case e_pfNodeDir::ev_left:  return {-1,  0};
-            case e_pfNodeDir::ev_up:    return { 0, -1};
-            default:                    return { 1,  0};
-        }
+        g_characterGrid.f_move(v_pfAgent, v_posX, v_posY, p_x, p_y);
+        v_posX = p_x;
+        v_posY = p_y;
+    }
+
+    void c_playerCharacter::f_pfIndexPath()
+    {
+        fg_getPfPathIndex().f_insert(v_pfAgent, v_posX, v_posY, v_pfPath);
+    }
+
+    bool c_playerCharacter::f_pfFindCachedPath(int p_goalX, int p_goalY, bool &p_isFound)
+    {
+        c_pfPathCacheKey l_key {v_pfAlgorithm, v_posX, v_posY, p_goalX, p_goalY, fg_getWorldRevision()};
+
+        if (!fg_getPfPathCache().f_find(l_key, v_pfPath, p_isFound))
+            return false;
+
+        v_pfGoalX = p_goalX;
+        v_pfGoalY = p_goalY;
+        v_pfWorldRevision = l_key.v_worldRevision;
+        v_pfSearchStats = {};
+        return true;
     }
 
-    c_playerCharacter::e_pfNodeDir c_playerCharacter::fs_pfOffsetToDir(int p_offsetX, int p_offsetY)
+    bool c_playerCharacter::f_pfBuildPathTo(int p_goalX, int p_goalY)
     {
-        if (p_offsetX ==  1 && p_offsetY ==  0) return e_pfNodeDir::ev_right;
-        if (p_offsetX ==  0 && p_offsetY ==  1) return e_pfNodeDir::ev_down;
-        if (p_offsetX == -1 && p_offsetY ==  0) return e_pfNodeDir::ev_left;
-        if (p_offsetX ==  0 && p_offsetY == -1) return e_pfNodeDir::ev_up;
-        return e_pfNodeDir::ev_right;
+        bool l_isFound {};
+
+        if (f_pfFindCachedPath(p_goalX, p_goalY, l_isFound))
+            return l_isFound;
+
+        v_pfPath.f_clear();
+        v_pfWorldRevision = fg_getWorldRevision();
+
+        c_worldView   l_world {fg_getLiveWorldView()};
+        c_pfNodeGrid &l_nodes {fg_getSharedPfNodeGrid()};
+
+        l_isFound = fg_pfSearch(v_pfAlgorithm, l_world, v_posX, v_posY, p_goalX, p_goalY, l_nodes, v_pfSearchStats);
+
+        if (l_isFound)
+            f_pfProcessNodesIntoPath(p_goalX, p_goalY, l_nodes);
+
+        fg_getPfPathCache().f_insert
+        ({v_pfAlgorithm, v_posX, v_posY, p_goalX, p_goalY, v_pfWorldRevision}, v_pfPath, l_isFound);
+
+        return l_isFound;
     }
 
-    c_playerCharacter::e_pfNodeDir c_playerCharacter::fs_pfReverseDir(e_pfNodeDir p_dir)
+    void c_playerCharacter::f_pfBuildSearchTree()
     {
-        switch (p_dir)
+        if (!v_pfTree)
+            v_pfTree = make_unique<c_pfNodeGrid>();
+
+        // A goal outside the world floods everything that is reachable, which is the whole tree.
+        fg_pfSearch
+        (e_pfAlgorithm::ev_wavefront, fg_getLiveWorldView(), v_posX, v_posY, -1, -1, *v_pfTree, v_pfSearchStats);
+
+        v_pfTreeRootX = v_posX;
+        v_pfTreeRootY = v_posY;
+        v_pfTreeWorldRevision = fg_getWorldRevision();
+        v_isPfTreeValid = true;
+    }
+
+    bool c_playerCharacter::f_pfBuildPathFromSearchTree(int p_goalX, int p_goalY)
+    {
+        v_pfPath.f_clear();
+        v_pfWorldRevision = fg_getWorldRevision();
+
+        if (!v_isPfTreeValid || v_pfTreeWorldRevision != fg_getWorldRevision())
+            f_pfBuildSearchTree();
+
+        // The tree can answer the goal if the goal's branch leads through the current position. The character only
+        // moves along the tree's branches, and the health on the rest of the branch can only be higher when starting
+        // from the current position, so the rest of the branch is a valid path.
+
+        bool l_isOnBranch {};
+
+        if (fg_isPosInWorldBounds(p_goalX, p_goalY) && v_pfTree->f_isVisited(p_goalX, p_goalY))
+        {
+            int l_x {p_goalX};
+            int l_y {p_goalY};
+
+            while ((l_x != v_posX || l_y != v_posY) && (l_x != v_pfTreeRootX || l_y != v_pfTreeRootY))
+            {
+                auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(v_pfTree->f_getNode(l_x, l_y).v_dir)};
+                l_x += l_offsetX;
+                l_y += l_offsetY;
+            }
+
+            l_isOnBranch = l_x == v_posX && l_y == v_posY;
+        }
+
+        if (!l_isOnBranch)
         {
-            case e_pfNodeDir::ev_right: return e_pfNodeDir::ev_left;
-            case e_pfNodeDir::ev_down:  return e_pfNodeDir::ev_up;
-            case e_pfNodeDir::ev_left:  return e_pfNodeDir::ev_right;
-            case e_pfNodeDir::ev_up:    return e_pfNodeDir::ev_down;
-            default:                    return e_pfNodeDir::ev_right;
+            // A tree rooted at the current position has every reachable goal.
+            if (v_pfTreeRootX == v_posX && v_pfTreeRootY == v_posY)
+                return false;
+
+            f_pfBuildSearchTree();
+            return f_pfBuildPathFromSearchTree(p_goalX, p_goalY);
         }
+
+        f_pfProcessNodesIntoPath(p_goalX, p_goalY, *v_pfTree);
+        return true;
     }
 
-    bool
-    c_playerCharacter::fs_pfSpreadNode(int p_fromX, int p_fromY, e_pfNodeDir p_dir, int p_creatorHealth, int p_goalX,
-    int p_goalY, t_pfNodesArr &p_pfNodes, t_pfNodePositions &p_newPfNodePositions)
+    size_t c_playerCharacter::f_pfFindBrokenStep(int &p_fromX, int &p_fromY, int &p_fromHealth) const
     {
-        auto [l_offsetX, l_offsetY] {fs_pfDirToOffset(p_dir)};
-        int l_x {p_fromX + l_offsetX};
-        int l_y {p_fromY + l_offsetY};
+        p_fromX = v_posX;
+        p_fromY = v_posY;
+        p_fromHealth = g_pfNodeMaxHealth;
 
-        if (!fg_isPosInWorldBounds(l_x, l_y) || g_staticObjs[l_x][l_y] != 0u)
-            return false;
+        for (size_t l_step {v_pfPath.f_getCursor()}; l_step != v_pfPath.f_getLength(); ++l_step)
+        {
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(v_pfPath.f_getStep(l_step))};
+            int l_x {p_fromX + l_offsetX};
+            int l_y {p_fromY + l_offsetY};
 
-        auto &l_node {p_pfNodes[l_x][l_y]};
+            if (!fg_isPosInWorldBounds(l_x, l_y) || g_staticObjs[l_x][l_y] != 0u)
+                return l_step;
 
-        if (l_node && l_node->v_health != 0)
-            return false;
-        
-        l_node = make_unique<c_pfNode>();
-        l_node->v_health = fs_pfIsPosNearWall(l_x, l_y) ? g_nodeMaxHealth : p_creatorHealth - 1;
-        l_node->v_dir = fs_pfReverseDir(p_dir);
+            int l_health {fg_isPosNearWall(l_x, l_y) ? g_pfNodeMaxHealth : p_fromHealth - 1};
 
-        if (l_node->v_health != 0)
-            p_newPfNodePositions.push_back({l_x, l_y});
-        
-        return l_x == p_goalX && l_y == p_goalY;
+            // Like in a search, a node with 0 health can't be spread further, so only the goal may have 0 health.
+            if (l_health == 0 && l_step + 1u != v_pfPath.f_getLength())
+                return l_step;
+
+            p_fromX = l_x;
+            p_fromY = l_y;
+            p_fromHealth = l_health;
+        }
+
+        return v_pfPath.f_getLength();
     }
 
-    void c_playerCharacter::f_pfProcessNodesIntoPath(int p_goalX, int p_goalY, t_pfNodesArr &p_pfNodes)
+    bool c_playerCharacter::f_pfIsPathIntactAround(size_t p_step, int p_x, int p_y) const
     {
-        v_pfPath = make_unique<t_pfNodesArr>();
-        v_pfGoalX = p_goalX;
-        v_pfGoalY = p_goalY;
+        // The step's index is from the path's indexing, so a path changed since then is checked whole instead.
+        if (p_step >= v_pfPath.f_getLength())
+            return false;
 
-        int l_x {p_goalX};
-        int l_y {p_goalY};
+        // Walks back to the nearest position whose health doesn't depend on the steps before it. That's a tile near a
+        // wall, or the character's position.
 
-        e_pfNodeDir l_dirToPrev   {};
-        bool        l_isFirstNode {true};
+        size_t l_fromStep {p_step};
+        int    l_fromX    {p_x};
+        int    l_fromY    {p_y};
 
         while (true)
         {
-            if (l_x == v_posX && l_y == v_posY)
-            {
-                auto &l_startNode {(*v_pfPath)[l_x][l_y]};
-                l_startNode = make_unique<c_pfNode>();
-                l_startNode->v_dir = l_dirToPrev;
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(v_pfPath.f_getStep(l_fromStep))};
+            l_fromX -= l_offsetX;
+            l_fromY -= l_offsetY;
+
+            if (l_fromStep == v_pfPath.f_getCursor())
                 break;
-            }
 
-            auto &l_pathNode {(*v_pfPath)[l_x][l_y]};
-            l_pathNode = move(p_pfNodes[l_x][l_y]);
+            if (!fg_isPosInWorldBounds(l_fromX, l_fromY))
+                return false;
 
-            auto [l_offsetX, l_offsetY] {fs_pfDirToOffset(l_pathNode->v_dir)};
-            l_x += l_offsetX;
-            l_y += l_offsetY;
+            if (fg_isPosNearWall(l_fromX, l_fromY))
+                break;
+
+            --l_fromStep;
+        }
+
+        if (l_fromStep == v_pfPath.f_getCursor() && (l_fromX != v_posX || l_fromY != v_posY))
+            return false;
+
+        // Walks forward like f_pfFindBrokenStep, until the health no longer depends on the step.
+
+        int l_fromHealth {g_pfNodeMaxHealth};
+
+        for (size_t l_step {l_fromStep}; l_step != v_pfPath.f_getLength(); ++l_step)
+        {
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(v_pfPath.f_getStep(l_step))};
+            l_fromX += l_offsetX;
+            l_fromY += l_offsetY;
+
+            if (!fg_isPosInWorldBounds(l_fromX, l_fromY) || g_staticObjs[l_fromX][l_fromY] != 0u)
+                return false;
+
+            bool l_isNearWall {fg_isPosNearWall(l_fromX, l_fromY)};
+            l_fromHealth = l_isNearWall ? g_pfNodeMaxHealth : l_fromHealth - 1;
 
-            if (l_isFirstNode)
-                l_isFirstNode = false; else
-                l_pathNode->v_dir = l_dirToPrev;
+            if (l_fromHealth == 0 && l_step + 1u != v_pfPath.f_getLength())
+                return false;
 
-            l_dirToPrev = fs_pfOffsetToDir(-l_offsetX, -l_offsetY);
+            if (l_isNearWall && l_step >= p_step)
+                return true;
         }
+
+        return true;
     }
 
-    bool c_playerCharacter::f_pfBuildPathTo(int p_goalX, int p_goalY)
+    bool c_playerCharacter::f_pfRepairStep(size_t p_brokenStep, int p_fromX, int p_fromY, int p_fromHealth)
     {
-        using enum e_pfNodeDir;
+        int l_windowX {p_fromX - g_pfRepairRadius};
+        int l_windowY {p_fromY - g_pfRepairRadius};
 
-        v_pfPath.reset();
+        auto fl_getWindowIndex = [&](int p_x, int p_y) -> int
+        {
+            int l_x {p_x - l_windowX};
+            int l_y {p_y - l_windowY};
 
-        t_pfNodesArr      l_nodes                {};
-        t_pfNodePositions l_processablePositions {};
-        t_pfNodePositions l_newPositions         {};
+            if (l_x < 0 || l_y < 0 || l_x >= g_pfRepairWindowW || l_y >= g_pfRepairWindowW)
+                return -1;
 
-        if
-        (
-            fs_pfSpreadNode(v_posX, v_posY, ev_right, g_nodeMaxHealth, p_goalX, p_goalY, l_nodes, l_newPositions) ||
-            fs_pfSpreadNode(v_posX, v_posY, ev_down,  g_nodeMaxHealth, p_goalX, p_goalY, l_nodes, l_newPositions) ||
-            fs_pfSpreadNode(v_posX, v_posY, ev_left,  g_nodeMaxHealth, p_goalX, p_goalY, l_nodes, l_newPositions) ||
-            fs_pfSpreadNode(v_posX, v_posY, ev_up,    g_nodeMaxHealth, p_goalX, p_goalY, l_nodes, l_newPositions)
-        )
+            return l_y * g_pfRepairWindowW + l_x;
+        };
+
+        // Marks the path's tiles after the broken step which a detour may rejoin. Those are the tiles near walls,
+        // since their health doesn't depend on the detour, and the goal.
+
+        g_pfRepairTargets.fill(0u);
+
+        int l_x {p_fromX};
+        int l_y {p_fromY};
+
+        for (size_t l_step {p_brokenStep}; l_step != v_pfPath.f_getLength(); ++l_step)
         {
-            f_pfProcessNodesIntoPath(p_goalX, p_goalY, l_nodes);
-            return true; // Found the goal.
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(v_pfPath.f_getStep(l_step))};
+            l_x += l_offsetX;
+            l_y += l_offsetY;
+
+            int l_windowIndex {fl_getWindowIndex(l_x, l_y)};
+
+            if (l_windowIndex == -1 || !fg_isPosInWorldBounds(l_x, l_y) || g_staticObjs[l_x][l_y] != 0u)
+                continue;
+
+            if (l_step + 1u == v_pfPath.f_getLength() || fg_isPosNearWall(l_x, l_y))
+                g_pfRepairTargets[l_windowIndex] = l_step + 1u;
         }
 
-        while (true)
+        // Searches for a detour inside the window, starting from the last intact tile with its health.
+
+        c_worldView        l_world                {fg_getLiveWorldView()};
+        c_pfNodeGrid      &l_nodes                {fg_getSharedPfNodeGrid()};
+        t_pfNodePositions &l_processablePositions {g_pfRepairProcessablePositions};
+        t_pfNodePositions &l_newPositions         {g_pfRepairNewPositions};
+
+        l_nodes.f_beginSearch();
+        l_processablePositions.clear();
+        l_newPositions.clear();
+
+        size_t l_rejoinIndex {v_pfPath.f_getLength()};
+        int    l_rejoinX     {v_pfGoalX};
+        int    l_rejoinY     {v_pfGoalY};
+        bool   l_isFound     {};
+
+        l_isFound = fg_pfSpreadNodeToNeighbours
+        (p_fromX, p_fromY, p_fromHealth, v_pfGoalX, v_pfGoalY, l_world, l_nodes, l_newPositions);
+
+        while (!l_isFound)
         {
-            l_processablePositions = move(l_newPositions);
+            l_processablePositions.swap(l_newPositions);
             l_newPositions.clear();
 
-            for (auto [l_x, l_y] : l_processablePositions)
+            if (l_processablePositions.empty())
+                return false; // The edit disconnected the path locally.
+
+            for (auto [l_posX, l_posY] : l_processablePositions)
             {
-                const auto &l_node {l_nodes[l_x][l_y]};
-                
+                int l_windowIndex {fl_getWindowIndex(l_posX, l_posY)};
+
+                if (l_windowIndex == -1)
+                    continue;
+
+                if (g_pfRepairTargets[l_windowIndex] != 0u)
+                {
+                    l_rejoinIndex = g_pfRepairTargets[l_windowIndex];
+                    l_rejoinX = l_posX;
+                    l_rejoinY = l_posY;
+                    l_isFound = true;
+                    break;
+                }
+
+                int l_health {l_nodes.f_getNode(l_posX, l_posY).v_health};
+
                 if
                 (
-                    fs_pfSpreadNode(l_x, l_y, ev_right, l_node->v_health, p_goalX, p_goalY, l_nodes, l_newPositions) ||
-                    fs_pfSpreadNode(l_x, l_y, ev_down,  l_node->v_health, p_goalX, p_goalY, l_nodes, l_newPositions) ||
-                    fs_pfSpreadNode(l_x, l_y, ev_left,  l_node->v_health, p_goalX, p_goalY, l_nodes, l_newPositions) ||
-                    fs_pfSpreadNode(l_x, l_y, ev_up,    l_node->v_health, p_goalX, p_goalY, l_nodes, l_newPositions)
+                    fg_pfSpreadNodeToNeighbours
+                    (l_posX, l_posY, l_health, v_pfGoalX, v_pfGoalY, l_world, l_nodes, l_newPositions)
                 )
                 {
-                    f_pfProcessNodesIntoPath(p_goalX, p_goalY, l_nodes);
-                    return true; // Found the goal.
+                    l_isFound = true;
+                    break;
                 }
             }
+        }
 
-            if (l_processablePositions.empty())
-                return false; // Didn't find the goal.
+        // Splices the detour between the intact part of the path and the rest of the path.
+
+        size_t l_detourLength {};
+
+        for (l_x = l_rejoinX, l_y = l_rejoinY; l_x != p_fromX || l_y != p_fromY; ++l_detourLength)
+        {
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_nodes.f_getNode(l_x, l_y).v_dir)};
+            l_x += l_offsetX;
+            l_y += l_offsetY;
+        }
+
+        size_t l_intactLength {p_brokenStep - v_pfPath.f_getCursor()};
+        size_t l_restLength   {v_pfPath.f_getLength() - l_rejoinIndex};
+
+        g_pfRepairedPath.f_resize(l_intactLength + l_detourLength + l_restLength);
+
+        for (size_t l_i {}; l_i != l_intactLength; ++l_i)
+            g_pfRepairedPath.f_setStep(l_i, v_pfPath.f_getStep(v_pfPath.f_getCursor() + l_i));
+
+        size_t l_index {l_intactLength + l_detourLength};
+
+        for (l_x = l_rejoinX, l_y = l_rejoinY; l_x != p_fromX || l_y != p_fromY;)
+        {
+            e_pfNodeDir l_dirToPrev {l_nodes.f_getNode(l_x, l_y).v_dir};
+            auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dirToPrev)};
+            l_x += l_offsetX;
+            l_y += l_offsetY;
+
+            g_pfRepairedPath.f_setStep(--l_index, fg_pfReverseDir(l_dirToPrev));
+        }
+
+        for (size_t l_i {}; l_i != l_restLength; ++l_i)
+            g_pfRepairedPath.f_setStep(l_intactLength + l_detourLength + l_i, v_pfPath.f_getStep(l_rejoinIndex + l_i));
+
+        swap(v_pfPath, g_pfRepairedPath);
+        return true;
+    }
+
+    bool c_playerCharacter::f_pfRepairPath()
+    {
+        for (int l_attempt {}; l_attempt != g_pfMaxRepairAttempts; ++l_attempt)
+        {
+            int    l_fromX      {};
+            int    l_fromY      {};
+            int    l_fromHealth {};
+            size_t l_brokenStep {f_pfFindBrokenStep(l_fromX, l_fromY, l_fromHealth)};
+
+            if (l_brokenStep == v_pfPath.f_getLength())
+            {
+                v_pfWorldRevision = fg_getWorldRevision();
+                return true;
+            }
+
+            if (!f_pfRepairStep(l_brokenStep, l_fromX, l_fromY, l_fromHealth))
+                return false;
+        }
+
+        return false;
+    }
+
+    void c_playerCharacter::f_pfCheckEditedPath()
+    {
+        if (v_pfReplanMode == e_pfReplanMode::ev_repair)
+        {
+            if (!f_pfRepairPath())
+                v_pfPath.f_clear();
+        }
+        else
+        {
+            int l_fromX      {};
+            int l_fromY      {};
+            int l_fromHealth {};
+
+            // The other modes rebuild a broken path anyway, so it's just cleared to be rebuilt on the next move.
+            if (f_pfFindBrokenStep(l_fromX, l_fromY, l_fromHealth) != v_pfPath.f_getLength())
+                v_pfPath.f_clear();
+        }
+
+        v_pfWorldRevision = fg_getWorldRevision();
+        f_pfIndexPath();
+    }
+
+    bool c_playerCharacter::f_pfPollPathJob(int p_goalX, int p_goalY, bool &p_isFound)
+    {
+        // A job for another goal is stale, since its result would be thrown away.
+        if (v_pfJob && v_pfJob->f_getGoal() != pair {p_goalX, p_goalY})
+            f_pfCancelPathJob();
+
+        if (!v_pfJob)
+        {
+            if (f_pfFindCachedPath(p_goalX, p_goalY, p_isFound))
+                return true;
+
+            // A goal in another region is answered at once, instead of a frame later by a job.
+            if
+            (
+                fg_isPosInWorldBounds(p_goalX, p_goalY) &&
+                fg_getLiveWorldView().f_isCutOff(v_posX, v_posY, p_goalX, p_goalY)
+            )
+            {
+                v_pfPath.f_clear();
+                v_pfSearchStats = {};
+                p_isFound = false;
+                return true;
+            }
+
+            v_pfJob = fg_requestPfJob(v_pfAlgorithm, v_posX, v_posY, p_goalX, p_goalY);
+        }
+
+        if (!v_pfJob->f_isDone())
+            return false;
+
+        v_pfPath.f_clear();
+        v_pfSearchStats = v_pfJob->f_getStats();
+        p_isFound = v_pfJob->f_isFound();
+
+        fg_getPfPathCache().f_insert
+        (
+            {v_pfAlgorithm, v_posX, v_posY, p_goalX, p_goalY, v_pfJob->f_getWorldRevision()},
+            v_pfJob->f_getPath(), p_isFound
+        );
+
+        if (p_isFound)
+        {
+            swap(v_pfPath, v_pfJob->f_getPath());
+            v_pfGoalX = p_goalX;
+            v_pfGoalY = p_goalY;
+
+            // The path is as old as the snapshot, so any later edits are handled like edits after a synchronous search.
+            v_pfWorldRevision = v_pfJob->f_getWorldRevision();
+        }
+
+        v_pfJob.reset();
+        return true;
+    }
+
+    void c_playerCharacter::f_pfCancelPathJob()
+    {
+        if (v_pfJob)
+        {
+            v_pfJob->f_cancel();
+            v_pfJob.reset();
+        }
+    }
+
+    bool c_playerCharacter::f_pfPollSlicedSearch(int p_goalX, int p_goalY, bool &p_isFound)
+    {
+        // A search for another goal is stale, since its result would be thrown away.
+        if (v_pfSlicedWorld && v_pfSlicedSearch->f_getGoal() != pair {p_goalX, p_goalY})
+            f_pfCancelSlicedSearch();
+
+        if (!v_pfSlicedWorld)
+        {
+            if (f_pfFindCachedPath(p_goalX, p_goalY, p_isFound))
+                return true;
+
+            if (!v_pfSlicedSearch)
+            {
+                v_pfSlicedSearch = make_unique<c_pfSlicedSearch>();
+                v_pfSlicedNodes = make_unique<c_pfNodeGrid>();
+            }
+
+            // The landmarks are only rebuilt on request, and the request has to come from the main thread.
+            if (v_pfAlgorithm == e_pfAlgorithm::ev_landmarks)
+                fg_updatePfLandmarks();
+
+            // The search may span several ticks, so it searches a snapshot that edits in the meantime don't change.
+            v_pfSlicedWorld = fg_getWorldSnapshot();
+            v_pfSlicedSearch->f_begin
+            (v_pfAlgorithm, v_pfSlicedWorld->f_getView(), v_posX, v_posY, p_goalX, p_goalY, *v_pfSlicedNodes);
+            v_pfSearchStats = {};
+        }
+
+        // The searches are resumed by fs_pfResumeSlicedSearches, except for the ones that finish without expanding.
+        if (v_pfSlicedSearch->f_getState() == e_pfSearchState::ev_searching)
+            return false;
+
+        v_pfPath.f_clear();
+        p_isFound = v_pfSlicedSearch->f_getState() == e_pfSearchState::ev_found;
+
+        if (p_isFound)
+            f_pfProcessNodesIntoPath(p_goalX, p_goalY, *v_pfSlicedNodes);
+
+        // The path is as old as the snapshot, so any later edits are handled like edits after a synchronous search.
+        v_pfWorldRevision = v_pfSlicedWorld->v_revision;
+
+        fg_getPfPathCache().f_insert
+        ({v_pfAlgorithm, v_posX, v_posY, p_goalX, p_goalY, v_pfWorldRevision}, v_pfPath, p_isFound);
+
+        v_pfSlicedWorld.reset();
+        return true;
+    }
+
+    size_t c_playerCharacter::f_pfResumeSlicedSearch(size_t p_nodeBudget)
+    {
+        uint64_t        l_startTime {SDL_GetPerformanceCounter()};
+        c_pfSearchStats l_stats     {};
+
+        v_pfSlicedSearch->f_resume(v_pfSlicedWorld->f_getView(), *v_pfSlicedNodes, p_nodeBudget, l_stats);
+
+        v_pfSearchStats.v_expandedNodes += l_stats.v_expandedNodes;
+        v_pfSearchStats.v_microseconds +=
+        (SDL_GetPerformanceCounter() - l_startTime) * 1'000'000u / SDL_GetPerformanceFrequency();
+
+        return l_stats.v_expandedNodes;
+    }
+
+    void c_playerCharacter::f_pfCancelSlicedSearch()
+    {
+        v_pfSlicedWorld.reset();
+    }
+
+    bool c_playerCharacter::f_pfUpdateFlowField(int p_goalX, int p_goalY)
+    {
+        // Like a new path, a new goal or a world edit starts the character over with the maximum health.
+
+        bool l_isNewGoal {!v_pfFlowField || v_pfFlowField->f_getGoal() != pair {p_goalX, p_goalY}};
+
+        if (l_isNewGoal)
+        {
+            v_pfFlowField = fg_getPfFlowField(p_goalX, p_goalY);
+            v_pfFlowHealth = g_pfNodeMaxHealth;
+        }
+
+        if (v_pfWorldRevision != fg_getWorldRevision())
+        {
+            v_pfWorldRevision = fg_getWorldRevision();
+            v_pfFlowHealth = g_pfNodeMaxHealth;
+        }
+
+        // Only the first character to notice a world edit rebuilds the shared field.
+        if (v_pfFlowField->f_update())
+            v_pfSearchStats = v_pfFlowField->f_getBuildStats();
+
+        return l_isNewGoal;
+    }
+
+    c_playerCharacter::e_pfMoveResult c_playerCharacter::f_pfMoveAlongFlowField(int p_goalX, int p_goalY)
+    {
+        f_pfUpdateFlowField(p_goalX, p_goalY);
+
+        e_pfNodeDir l_dir {};
+
+        if (!v_pfFlowField->f_getNextStep(v_posX, v_posY, v_pfFlowHealth, l_dir))
+            return e_pfMoveResult::ev_cannotReachGoal;
+
+        if (fg_getSimTime() < v_nextMoveTime)
+            return e_pfMoveResult::ev_continue;
+
+        auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(l_dir)};
+        f_moveTo(v_posX + l_offsetX, v_posY + l_offsetY);
+        v_pfFlowHealth = fg_isPosNearWall(v_posX, v_posY) ? g_pfNodeMaxHealth : v_pfFlowHealth - 1;
+
+        v_nextMoveTime = fg_getSimTime() + v_moveInterval;
+
+        if (v_posX == p_goalX && v_posY == p_goalY)
+            return e_pfMoveResult::ev_reachedGoal;
+
+        return e_pfMoveResult::ev_continue;
+    }
+
+    c_playerCharacter::e_pfMoveResult c_playerCharacter::f_pfMoveCooperatively(int p_goalX, int p_goalY)
+    {
+        // The plan for the old goal is dropped, and the next step plans for the new one.
+        if (f_pfUpdateFlowField(p_goalX, p_goalY))
+            f_pfReleaseCooperativePlan();
+
+        if (v_pfFlowField->f_getCost(v_posX, v_posY, v_pfFlowHealth) == g_pfNoFlowCost)
+            return e_pfMoveResult::ev_cannotReachGoal;
+
+        // The moves are taken by fs_pfMoveCooperatively, at the same time as the other characters' moves.
+        if (v_pfCooperativePositions.empty())
+            return e_pfMoveResult::ev_searching;
+
+        return e_pfMoveResult::ev_continue;
+    }
+
+    void c_playerCharacter::f_pfTakeCooperativeStep(uint64_t p_step)
+    {
+        if (v_pfCooperativePositions.empty())
+            return;
+
+        size_t l_index {static_cast<size_t>(p_step - v_pfCooperativeStep)};
+
+        if (l_index >= v_pfCooperativePositions.size())
+        {
+            f_pfReleaseCooperativePlan();
+            return;
+        }
+
+        auto [l_x, l_y] {v_pfCooperativePositions[l_index]};
+
+        if (l_x == v_posX && l_y == v_posY)
+            return;
+
+        // A wall may have been placed on the plan since it was made, in which case the character waits for a new plan.
+        if (g_staticObjs[l_x][l_y] != 0u)
+        {
+            f_pfReleaseCooperativePlan();
+            return;
+        }
+
+        f_moveTo(l_x, l_y);
+        v_pfFlowHealth = fg_isPosNearWall(v_posX, v_posY) ? g_pfNodeMaxHealth : v_pfFlowHealth - 1;
+    }
+
+    void c_playerCharacter::f_pfPlanCooperatively(c_pfCooperativeStats &p_stats)
+    {
+        uint64_t l_startTime {SDL_GetPerformanceCounter()};
+
+        f_pfReleaseCooperativePlan();
+        v_pfFlowField->f_update();
+
+        v_pfSearchStats = {};
+
+        bool l_isFound
+        {
+            fg_pfSearchCooperative
+            (
+                fg_getLiveWorldView(), *v_pfFlowField, g_pfReservations, v_pfAgent, v_posX, v_posY,
+                v_pfFlowHealth, v_pfCooperativePositions, v_pfSearchStats
+            )
+        };
+
+        // A plan that runs into the reservations is followed as far as it goes, but planned again every step. Its end
+        // is still reserved for the rest of the window, so that the others don't plan through the waiting character.
+        v_isPfCooperativeBlocked = !l_isFound;
+
+        if (v_isPfCooperativeBlocked)
+            ++p_stats.v_blockedAgents;
+
+        v_pfCooperativeStep = g_pfReservations.f_getStep();
+
+        for (size_t l_i {}; l_i != v_pfCooperativePositions.size(); ++l_i)
+        {
+            auto [l_x, l_y] {v_pfCooperativePositions[l_i]};
+            g_pfReservations.f_reserve(l_x, l_y, v_pfCooperativeStep + l_i, v_pfAgent);
         }
+
+        v_pfSearchStats.v_microseconds =
+        (SDL_GetPerformanceCounter() - l_startTime) * 1'000'000u / SDL_GetPerformanceFrequency();
+
+        ++p_stats.v_plannedAgents;
+        p_stats.v_expandedNodes += v_pfSearchStats.v_expandedNodes;
+    }
+
+    void c_playerCharacter::f_pfReleaseCooperativePlan()
+    {
+        for (size_t l_i {}; l_i != v_pfCooperativePositions.size(); ++l_i)
+        {
+            auto [l_x, l_y] {v_pfCooperativePositions[l_i]};
+            g_pfReservations.f_release(l_x, l_y, v_pfCooperativeStep + l_i, v_pfAgent);
+        }
+
+        v_pfCooperativePositions.clear();
     }
 
 #endif
@@ -205,9 +782,15 @@ constexpr int g_nodeMaxHealth {15};
 // Public members.
 #if 1
 
-    c_playerCharacter::c_playerCharacter(int p_posX, int p_posY) : v_posX {p_posX}, v_posY {p_posY}
+    c_playerCharacter::c_playerCharacter(int p_posX, int p_posY)
+    : v_pfAgent {g_pfNextAgent++}, v_posX {p_posX}, v_posY {p_posY}
     {
+        g_characterGrid.f_insert(v_pfAgent, v_posX, v_posY);
+    }
 
+    uint32_t c_playerCharacter::f_getAgent() const
+    {
+        return v_pfAgent;
     }
 
     std::pair<int, int> c_playerCharacter::f_getPos() const
@@ -217,8 +800,99 @@ constexpr int g_nodeMaxHealth {15};
 
     void c_playerCharacter::f_setPos(int p_posX, int p_posY)
     {
-        v_posX = p_posX;
-        v_posY = p_posY;
+        f_moveTo(p_posX, p_posY);
+
+        // The path's steps are relative to the position, so the path is no longer valid. Neither is the search tree,
+        // since the new position might not be on its branches.
+        v_pfPath.f_clear();
+        v_isPfTreeValid = false;
+        f_pfCancelPathJob();
+        f_pfCancelSlicedSearch();
+        f_pfReleaseCooperativePlan();
+        fg_getPfPathIndex().f_erase(v_pfAgent);
+        v_pfFlowHealth = g_pfNodeMaxHealth;
+
+        // A character which has reached its goal may have been moved away from it.
+        if (v_hasGoal)
+            g_moveScheduler.f_schedule(v_pfAgent, fg_getSimTime());
+    }
+
+    c_playerCharacter::e_pfReplanMode c_playerCharacter::f_getPfReplanMode() const
+    {
+        return v_pfReplanMode;
+    }
+
+    void c_playerCharacter::f_setPfReplanMode(e_pfReplanMode p_mode)
+    {
+        v_pfReplanMode = p_mode;
+
+        if (v_pfReplanMode != e_pfReplanMode::ev_searchTree)
+        {
+            v_pfTree.reset();
+            v_isPfTreeValid = false;
+        }
+
+        // The cooperative planning uses the flow field as its heuristic.
+        if (v_pfReplanMode != e_pfReplanMode::ev_flowField && v_pfReplanMode != e_pfReplanMode::ev_cooperative)
+            v_pfFlowField.reset();
+
+        if (v_pfReplanMode != e_pfReplanMode::ev_cooperative)
+            f_pfReleaseCooperativePlan();
+
+        // Wakes at once, so that the goal is followed in the new mode.
+        if (v_hasGoal)
+            g_moveScheduler.f_schedule(v_pfAgent, fg_getSimTime());
+    }
+
+    void c_playerCharacter::f_setPfAlgorithm(e_pfAlgorithm p_algorithm)
+    {
+        v_pfAlgorithm = p_algorithm;
+    }
+
+    void c_playerCharacter::f_setPfAsync(bool p_isAsync)
+    {
+        v_isPfAsync = p_isAsync;
+
+        if (!v_isPfAsync)
+            f_pfCancelPathJob();
+    }
+
+    void c_playerCharacter::f_setPfSliced(bool p_isSliced)
+    {
+        v_isPfSliced = p_isSliced;
+
+        if (!v_isPfSliced)
+        {
+            f_pfCancelSlicedSearch();
+            v_pfSlicedSearch.reset();
+            v_pfSlicedNodes.reset();
+        }
+    }
+
+    void c_playerCharacter::f_setGoal(int p_goalX, int p_goalY)
+    {
+        if (v_hasGoal && p_goalX == v_goalX && p_goalY == v_goalY)
+            return;
+
+        v_goalX = p_goalX;
+        v_goalY = p_goalY;
+        v_hasGoal = true;
+
+        // Wakes at once, so that the new goal is planned for. The move still waits for its time.
+        g_moveScheduler.f_schedule(v_pfAgent, fg_getSimTime());
+    }
+
+    void c_playerCharacter::f_setMoveSpeed(float p_tilesPerSecond)
+    {
+        if (!(p_tilesPerSecond > 0.f))
+            throw invalid_argument {"Failed to set the move speed; the given value is invalid."};
+
+        v_moveInterval = max(static_cast<uint64_t>(lround(1000.f / p_tilesPerSecond)), static_cast<uint64_t>(1));
+    }
+
+    const c_pfSearchStats &c_playerCharacter::f_getPfSearchStats() const
+    {
+        return v_pfSearchStats;
     }
 
     c_playerCharacter::e_pfMoveResult c_playerCharacter::f_pfMoveTowardsGoal(int p_goalX, int p_goalY)
@@ -226,28 +900,68 @@ constexpr int g_nodeMaxHealth {15};
         if (v_posX == p_goalX && v_posY == p_goalY)
             return e_pfMoveResult::ev_reachedGoal;
 
-        if (!v_pfPath || p_goalX != v_pfGoalX || p_goalY != v_pfGoalY)
-            if (!f_pfBuildPathTo(p_goalX, p_goalY))
+        if (v_pfReplanMode == e_pfReplanMode::ev_flowField)
+            return f_pfMoveAlongFlowField(p_goalX, p_goalY);
+
+        if (v_pfReplanMode == e_pfReplanMode::ev_cooperative)
+            return f_pfMoveCooperatively(p_goalX, p_goalY);
+
+        bool l_isPathUsable {v_pfPath.f_getRemainingLength() != 0u && p_goalX == v_pfGoalX && p_goalY == v_pfGoalY};
+
+        // In the repair mode, a world edit only leads to a rebuild if the path can't be repaired locally.
+        if (l_isPathUsable && v_pfReplanMode == e_pfReplanMode::ev_repair && v_pfWorldRevision != fg_getWorldRevision())
+        {
+            l_isPathUsable = f_pfRepairPath();
+            f_pfIndexPath();
+        }
+
+        if (!l_isPathUsable)
+        {
+            // The clusters are only kept for the live world, so the hierarchical search of a snapshot would only be
+            // the A*-search. It's done synchronously instead, which stays cheap since it plans coarse first.
+            bool l_canSearchSnapshot {v_pfAlgorithm != e_pfAlgorithm::ev_hierarchical};
+            bool l_isPathBuilt       {};
+
+            if (v_pfReplanMode == e_pfReplanMode::ev_searchTree)
+                l_isPathBuilt = f_pfBuildPathFromSearchTree(p_goalX, p_goalY);
+            else if (v_isPfAsync && l_canSearchSnapshot)
+            {
+                // Waits in place until the worker is done, so that the path still starts from the position.
+                if (!f_pfPollPathJob(p_goalX, p_goalY, l_isPathBuilt))
+                    return e_pfMoveResult::ev_searching;
+            }
+            else if (v_isPfSliced && l_canSearchSnapshot)
+            {
+                // Waits in place until the search is done, like for a worker.
+                if (!f_pfPollSlicedSearch(p_goalX, p_goalY, l_isPathBuilt))
+                    return e_pfMoveResult::ev_searching;
+            }
+            else
+                l_isPathBuilt = f_pfBuildPathTo(p_goalX, p_goalY);
+
+            f_pfIndexPath();
+
+            if (!l_isPathBuilt)
                 return e_pfMoveResult::ev_cannotReachGoal;
+        }
         
-        if (SDL_GetTicks64() < v_nextMoveTime)
+        if (fg_getSimTime() < v_nextMoveTime)
             return e_pfMoveResult::ev_continue;
 
-        auto &l_pathNode {(*v_pfPath)[v_posX][v_posY]};
-        auto [l_offsetX, l_offsetY] {fs_pfDirToOffset(l_pathNode->v_dir)};
+        auto [l_offsetX, l_offsetY] {fg_pfDirToOffset(v_pfPath.f_getNextStep())};
         int l_nextPosX {v_posX + l_offsetX};
         int l_nextPosY {v_posY + l_offsetY};
 
         if (g_staticObjs[l_nextPosX][l_nextPosY] != 0u)
         {
-            v_pfPath.reset();
+            v_pfPath.f_clear();
             return f_pfMoveTowardsGoal(p_goalX, p_goalY);
         }
 
-        v_posX = l_nextPosX;
-        v_posY = l_nextPosY;
+        f_moveTo(l_nextPosX, l_nextPosY);
+        v_pfPath.f_advance();
 
-        v_nextMoveTime = SDL_GetTicks64() + static_cast<uint64_t>(50);
+        v_nextMoveTime = fg_getSimTime() + v_moveInterval;
 
         if (v_posX == p_goalX && v_posY == p_goalY)
             return e_pfMoveResult::ev_reachedGoal;
@@ -255,6 +969,286 @@ constexpr int g_nodeMaxHealth {15};
         return e_pfMoveResult::ev_continue;
     }
 
+    void c_playerCharacter::fs_findCharactersInRect
+    (int p_fromX, int p_fromY, int p_toX, int p_toY, vector<c_playerCharacter *> &p_characters)
+    {
+        vector<uint32_t> &l_agents {g_foundAgents};
+        l_agents.clear();
+        g_characterGrid.f_findInRect(p_fromX, p_fromY, p_toX, p_toY, l_agents);
+
+        for (uint32_t l_agent : l_agents)
+        {
+            c_playerCharacter *l_character {fg_findCharacter(l_agent)};
+
+            // The grid keeps the agents of the removed characters, which aren't found anymore.
+            if
+            (
+                l_character &&
+                l_character->v_posX >= p_fromX && l_character->v_posX < p_toX &&
+                l_character->v_posY >= p_fromY && l_character->v_posY < p_toY
+            )
+            {
+                p_characters.push_back(l_character);
+            }
+        }
+    }
+
+    void c_playerCharacter::fs_moveScheduledCharacters()
+    {
+        uint64_t          l_time   {fg_getSimTime()};
+        vector<uint32_t> &l_agents {g_dueAgents};
+        l_agents.clear();
+        g_moveScheduler.f_advanceTo(l_time, l_agents);
+
+        for (uint32_t l_agent : l_agents)
+        {
+            c_playerCharacter *l_character {fg_findCharacter(l_agent)};
+
+            if (!l_character || !l_character->v_hasGoal)
+                continue;
+
+            e_pfMoveResult l_result {l_character->f_pfMoveTowardsGoal(l_character->v_goalX, l_character->v_goalY)};
+
+            // The cooperative characters are moved in lockstep by fs_pfMoveCooperatively, so they're only woken to
+            // follow a new goal, or to try again while it can't be reached.
+            if
+            (
+                l_character->v_pfReplanMode == e_pfReplanMode::ev_cooperative &&
+                l_result != e_pfMoveResult::ev_cannotReachGoal
+            )
+            {
+                continue;
+            }
+
+            // A character that has reached its goal sleeps until it gets a new goal or is moved.
+            switch (l_result)
+            {
+                case e_pfMoveResult::ev_continue:
+                {
+                    uint64_t l_nextTime
+                    {
+                        l_character->v_nextMoveTime > l_time ?
+                        l_character->v_nextMoveTime : l_time + l_character->v_moveInterval
+                    };
+
+                    g_moveScheduler.f_schedule(l_agent, l_nextTime);
+                    break;
+                }
+                case e_pfMoveResult::ev_searching:
+                    g_moveScheduler.f_schedule(l_agent, l_time + 1u);
+                    break;
+                case e_pfMoveResult::ev_cannotReachGoal:
+                    g_moveScheduler.f_schedule(l_agent, l_time + l_character->v_moveInterval);
+                    break;
+                case e_pfMoveResult::ev_reachedGoal:
+                    break;
+            }
+        }
+    }
+
+    void c_playerCharacter::fs_pfResumeSlicedSearches(size_t p_nodeBudget)
+    {
+        vector<c_playerCharacter *> &l_searchers {g_pfSlicedSearchers};
+        l_searchers.clear();
+
+        for (c_playerCharacter &l_character : g_playerCharacters)
+        {
+            if
+            (
+                l_character.v_pfSlicedWorld &&
+                l_character.v_pfSlicedSearch->f_getState() == e_pfSearchState::ev_searching
+            )
+            {
+                l_searchers.push_back(&l_character);
+            }
+        }
+
+        if (l_searchers.empty())
+            return;
+
+        // If the budget doesn't go around, the characters that are left out this tick are served first in the next.
+        size_t l_firstSearcher {g_pfSlicedSearchTurn++ % l_searchers.size()};
+        rotate(l_searchers.begin(), l_searchers.begin() + static_cast<ptrdiff_t>(l_firstSearcher), l_searchers.end());
+
+        // Every unfinished search gets an equal share of the budget. The shares that the finished searches didn't use
+        // are shared again among the rest, until the budget runs out or every search has finished.
+        while (p_nodeBudget != 0u && !l_searchers.empty())
+        {
+            size_t l_share {max(p_nodeBudget / l_searchers.size(), static_cast<size_t>(1u))};
+
+            for (size_t l_i {}; l_i != l_searchers.size() && p_nodeBudget != 0u;)
+            {
+                c_playerCharacter &l_character {*l_searchers[l_i]};
+                p_nodeBudget -= l_character.f_pfResumeSlicedSearch(min(l_share, p_nodeBudget));
+
+                if (l_character.v_pfSlicedSearch->f_getState() == e_pfSearchState::ev_searching)
+                {
+                    ++l_i;
+                    continue;
+                }
+
+                l_searchers[l_i] = l_searchers.back();
+                l_searchers.pop_back();
+            }
+        }
+    }
+
+    void c_playerCharacter::fs_pfCheckEditedPaths()
+    {
+        if (g_pfPathIndexRevision == fg_getWorldRevision())
+            return;
+
+        uint64_t l_checkedRevision {g_pfPathIndexRevision};
+        g_pfPathIndexRevision = fg_getWorldRevision();
+
+        t_pfNodePositions       &l_tiles {g_pfEditedTiles};
+        vector<c_pfIndexedStep> &l_steps {g_pfEditedSteps};
+        l_tiles.clear();
+        l_steps.clear();
+
+        // If the edits are too many to be known, every path is checked.
+        bool l_isEveryPathChecked {!fg_getWorldEditsSince(l_checkedRevision, l_tiles)};
+
+        if (!l_isEveryPathChecked)
+        {
+            for (auto [l_x, l_y] : l_tiles)
+                fg_getPfPathIndex().f_findSteps(l_x, l_y, l_steps);
+
+            sort(l_steps.begin(), l_steps.end());
+        }
+
+        for (c_playerCharacter &l_character : g_playerCharacters)
+        {
+            uint32_t l_agent {l_character.v_pfAgent};
+            auto     l_step
+            {
+                lower_bound
+                (
+                    l_steps.begin(), l_steps.end(), l_agent,
+                    [](const c_pfIndexedStep &p_step, uint32_t p_agent) {return p_step.v_agent < p_agent;}
+                )
+            };
+            bool l_isIndexed {l_step != l_steps.end() && l_step->v_agent == l_agent};
+
+            // The flow field and the cooperative planning follow the world's revision themselves. The paths that they
+            // left, and the finished ones, are only dropped from the index when an edit comes across them.
+            if
+            (
+                l_character.v_pfReplanMode == e_pfReplanMode::ev_flowField ||
+                l_character.v_pfReplanMode == e_pfReplanMode::ev_cooperative ||
+                l_character.v_pfPath.f_getRemainingLength() == 0u
+            )
+            {
+                if (l_isIndexed)
+                    fg_getPfPathIndex().f_erase(l_agent);
+
+                continue;
+            }
+
+            if (l_character.v_pfWorldRevision == g_pfPathIndexRevision)
+                continue;
+
+            // A path from an earlier revision than the checked one, like a cached one, may be broken by older edits.
+            bool l_isIntact {!l_isEveryPathChecked && l_character.v_pfWorldRevision == l_checkedRevision};
+
+            // The steps already taken can't break the rest of the path.
+            for (; l_isIntact && l_step != l_steps.end() && l_step->v_agent == l_agent; ++l_step)
+            {
+                if (l_step->v_step >= l_character.v_pfPath.f_getCursor())
+                    l_isIntact = l_character.f_pfIsPathIntactAround(l_step->v_step, l_step->v_x, l_step->v_y);
+            }
+
+            // Only a broken path is repaired and indexed again, so an intact one keeps its indexed steps.
+            if (l_isIntact)
+                l_character.v_pfWorldRevision = g_pfPathIndexRevision;
+            else
+                l_character.f_pfCheckEditedPath();
+        }
+    }
+
+    void c_playerCharacter::fs_pfMoveCooperatively()
+    {
+        if (fg_getSimTime() < g_pfNextCooperativeStepTime)
+            return;
+
+        uint64_t                     l_startTime {SDL_GetPerformanceCounter()};
+        uint64_t                     l_interval  {1u};
+        vector<c_playerCharacter *> &l_agents    {g_pfCooperativeAgents};
+        l_agents.clear();
+
+        for (c_playerCharacter &l_character : g_playerCharacters)
+        {
+            // A character without a flow field hasn't been given a goal yet.
+            if (l_character.v_pfReplanMode == e_pfReplanMode::ev_cooperative && l_character.v_pfFlowField)
+            {
+                l_agents.push_back(&l_character);
+                l_interval = max(l_interval, l_character.v_moveInterval);
+            }
+        }
+
+        // The characters step in lockstep, so they go at the speed of the slowest one, which keeps every character
+        // within its own speed. The time is advanced from the previous step's time, so that the steps don't drift
+        // later with the ticks. After a pause longer than a step, such as while there were no cooperative characters,
+        // the steps begin again from now instead of catching up.
+        g_pfNextCooperativeStepTime += l_interval;
+
+        if (g_pfNextCooperativeStepTime <= fg_getSimTime())
+            g_pfNextCooperativeStepTime = fg_getSimTime() + l_interval;
+
+        g_pfCooperativeStats = {};
+        g_pfCooperativeStats.v_agentCount = l_agents.size();
+
+        uint64_t l_step {g_pfReservations.f_getStep() + 1u};
+        g_pfReservations.f_advanceTo(l_step);
+
+        for (c_playerCharacter *l_agent : l_agents)
+            l_agent->f_pfTakeCooperativeStep(l_step);
+
+        // After a world edit, every plan is made again, since the reserved moves may go through the new walls.
+        if (g_pfCooperativeWorldRevision != fg_getWorldRevision())
+        {
+            g_pfCooperativeWorldRevision = fg_getWorldRevision();
+            g_pfReservations.f_clear();
+
+            // The positions are reserved before anyone plans, so that the characters that plan first don't plan
+            // through the others. The next step is reserved too, so that every character can at least wait.
+            for (c_playerCharacter *l_agent : l_agents)
+            {
+                l_agent->v_pfCooperativePositions.clear();
+                g_pfReservations.f_reserve(l_agent->v_posX, l_agent->v_posY, l_step, l_agent->v_pfAgent);
+                g_pfReservations.f_reserve(l_agent->v_posX, l_agent->v_posY, l_step + 1u, l_agent->v_pfAgent);
+            }
+        }
+
+        if (!l_agents.empty())
+        {
+            size_t l_firstAgent {g_pfCooperativeTurn++ % l_agents.size()};
+            rotate(l_agents.begin(), l_agents.begin() + static_cast<ptrdiff_t>(l_firstAgent), l_agents.end());
+        }
+
+        // Every character plans again every half window. The characters are spread over the steps by their agents, so
+        // that every step only plans a share of them. The characters without a plan and the blocked ones plan at once.
+        for (c_playerCharacter *l_agent : l_agents)
+        {
+            if
+            (
+                l_agent->v_pfCooperativePositions.empty() || l_agent->v_isPfCooperativeBlocked ||
+                (l_step + l_agent->v_pfAgent) % g_pfCooperativeRoundSteps == 0u
+            )
+            {
+                l_agent->f_pfPlanCooperatively(g_pfCooperativeStats);
+            }
+        }
+
+        g_pfCooperativeStats.v_microseconds =
+        (SDL_GetPerformanceCounter() - l_startTime) * 1'000'000u / SDL_GetPerformanceFrequency();
+    }
+
+    const c_pfCooperativeStats &c_playerCharacter::fs_getPfCooperativeStats()
+    {
+        return g_pfCooperativeStats;
+    }
+
 #endif
 
 }
\ No newline at end of file
@@ -7,9 +7,18 @@
 #pragma once
 
 #include "main.hpp"
-
-#include <array>
+#include "pfCooperative.hpp"
+#include "pfFlowField.hpp"
+#include "pfJobs.hpp"
+#include "pfNodeGrid.hpp"
+#include "pfPath.hpp"
+#include "pfPathCache.hpp"
+#include "pfSearch.hpp"
+
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 
@@ -23,22 +32,42 @@ namespace n_tdg
  **********************************************************************************************************************/
 class c_playerCharacter
 {
-    private:
+    public:
 
-    enum class e_pfNodeDir {ev_right, ev_down, ev_left, ev_up};
+    enum class e_pfReplanMode {ev_rebuild, ev_repair, ev_searchTree, ev_flowField, ev_cooperative};
 
-    class c_pfNode
-    {
-        public:
-        int v_health {};
-        e_pfNodeDir v_dir {};
-    };
+    enum class e_pfMoveResult {ev_continue, ev_searching, ev_reachedGoal, ev_cannotReachGoal};
 
-    using t_pfNodesArr = std::array<std::array<std::unique_ptr<c_pfNode>, g_worldH>, g_worldW>;
-    using t_pfNodePositions = std::vector<std::pair<int, int>>;
+    private:
 
-    std::unique_ptr<t_pfNodesArr> v_pfPath {};
+    uint32_t v_pfAgent {};
+    c_pfPath v_pfPath {};
+    uint64_t v_pfWorldRevision {};
+    e_pfReplanMode v_pfReplanMode {e_pfReplanMode::ev_rebuild};
+    e_pfAlgorithm v_pfAlgorithm {e_pfAlgorithm::ev_wavefront};
+    c_pfSearchStats v_pfSearchStats {};
+    std::unique_ptr<c_pfNodeGrid> v_pfTree {};
+    int v_pfTreeRootX {};
+    int v_pfTreeRootY {};
+    uint64_t v_pfTreeWorldRevision {};
+    bool v_isPfTreeValid {};
+    bool v_isPfAsync {};
+    std::shared_ptr<c_pfJob> v_pfJob {};
+    bool v_isPfSliced {};
+    std::unique_ptr<c_pfSlicedSearch> v_pfSlicedSearch {};
+    std::unique_ptr<c_pfNodeGrid> v_pfSlicedNodes {};
+    std::shared_ptr<const c_worldSnapshot> v_pfSlicedWorld {};
+    std::shared_ptr<c_pfFlowField> v_pfFlowField {};
+    int v_pfFlowHealth {g_pfNodeMaxHealth};
+    std::vector<std::pair<int, int>> v_pfCooperativePositions {};
+    uint64_t v_pfCooperativeStep {};
+    bool v_isPfCooperativeBlocked {};
     uint64_t v_nextMoveTime {};
+    uint64_t v_moveInterval {50};
+
+    int v_goalX {};
+    int v_goalY {};
+    bool v_hasGoal {};
 
     int v_posX {};
     int v_posY {};
@@ -46,33 +75,92 @@ class c_playerCharacter
     int v_pfGoalX {};
     int v_pfGoalY {};
 
-    static bool fs_pfIsPosNearWall(int p_x, int p_y);
+    void f_moveTo(int p_x, int p_y);
 
-    static std::pair<int, int> fs_pfDirToOffset(e_pfNodeDir p_dir);
+    void f_pfProcessNodesIntoPath(int p_goalX, int p_goalY, const c_pfNodeGrid &p_pfNodes);
 
-    static e_pfNodeDir fs_pfOffsetToDir(int p_offsetX, int p_offsetY);
+    void f_pfIndexPath();
 
-    static e_pfNodeDir fs_pfReverseDir(e_pfNodeDir p_dir);
+    bool f_pfFindCachedPath(int p_goalX, int p_goalY, bool &p_isFound);
 
-    static bool
-    fs_pfSpreadNode(int p_fromX, int p_fromY, e_pfNodeDir p_dir, int p_creatorHealth, int p_goalX, int p_goalY,
-    t_pfNodesArr &p_pfNodes, t_pfNodePositions &p_newPfNodePositions);
+    bool f_pfBuildPathTo(int p_goalX, int p_goalY);
 
-    void f_pfProcessNodesIntoPath(int p_goalX, int p_goalY, t_pfNodesArr &p_pfNodes);
+    void f_pfBuildSearchTree();
 
-    bool f_pfBuildPathTo(int p_goalX, int p_goalY);
+    bool f_pfBuildPathFromSearchTree(int p_goalX, int p_goalY);
+
+    size_t f_pfFindBrokenStep(int &p_fromX, int &p_fromY, int &p_fromHealth) const;
+
+    bool f_pfIsPathIntactAround(size_t p_step, int p_x, int p_y) const;
+
+    bool f_pfRepairStep(size_t p_brokenStep, int p_fromX, int p_fromY, int p_fromHealth);
+
+    bool f_pfRepairPath();
+
+    void f_pfCheckEditedPath();
+
+    bool f_pfPollPathJob(int p_goalX, int p_goalY, bool &p_isFound);
+
+    void f_pfCancelPathJob();
+
+    bool f_pfPollSlicedSearch(int p_goalX, int p_goalY, bool &p_isFound);
+
+    size_t f_pfResumeSlicedSearch(size_t p_nodeBudget);
+
+    void f_pfCancelSlicedSearch();
+
+    bool f_pfUpdateFlowField(int p_goalX, int p_goalY);
+
+    e_pfMoveResult f_pfMoveAlongFlowField(int p_goalX, int p_goalY);
+
+    e_pfMoveResult f_pfMoveCooperatively(int p_goalX, int p_goalY);
+
+    void f_pfTakeCooperativeStep(uint64_t p_step);
+
+    void f_pfPlanCooperatively(c_pfCooperativeStats &p_stats);
+
+    void f_pfReleaseCooperativePlan();
 
     public:
 
     c_playerCharacter(int p_posX, int p_posY);
 
+    uint32_t f_getAgent() const;
+
     std::pair<int, int> f_getPos() const;
 
     void f_setPos(int p_posX, int p_posY);
 
-    enum class e_pfMoveResult {ev_continue, ev_reachedGoal, ev_cannotReachGoal};
+    e_pfReplanMode f_getPfReplanMode() const;
+
+    void f_setPfReplanMode(e_pfReplanMode p_mode);
+
+    void f_setPfAlgorithm(e_pfAlgorithm p_algorithm);
+
+    void f_setPfAsync(bool p_isAsync);
+
+    void f_setPfSliced(bool p_isSliced);
+
+    void f_setGoal(int p_goalX, int p_goalY);
+
+    void f_setMoveSpeed(float p_tilesPerSecond);
+
+    const c_pfSearchStats &f_getPfSearchStats() const;
 
     e_pfMoveResult f_pfMoveTowardsGoal(int p_goalX, int p_goalY);
+
+    static void fs_findCharactersInRect
+    (int p_fromX, int p_fromY, int p_toX, int p_toY, std::vector<c_playerCharacter *> &p_characters);
+
+    static void fs_moveScheduledCharacters();
+
+    static void fs_pfResumeSlicedSearches(size_t p_nodeBudget);
+
+    static void fs_pfMoveCooperatively();
+
+    static void fs_pfCheckEditedPaths();
+
+    static const c_pfCooperativeStats &fs_getPfCooperativeStats();
 };
 
 }
\ No newline at end of file
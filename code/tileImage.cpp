@@ -0,0 +1,99 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The source file of @c c_tileImage.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "tileImage.hpp"
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+// Public members.
+#if 1
+
+    c_tileImage::c_tileImage() : v_texels(static_cast<size_t>(g_worldW) * static_cast<size_t>(g_worldH))
+    {
+
+    }
+
+    bool c_tileImage::f_createTexture(SDL_Renderer *p_renderer)
+    {
+        if (v_texture)
+            return true;
+
+        v_texture =
+        SDL_CreateTexture(p_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, g_worldW, g_worldH);
+
+        if (!v_texture)
+            return false;
+
+        SDL_SetTextureBlendMode(v_texture, SDL_BLENDMODE_BLEND);
+        v_dirtyRows.fill(true);
+
+        return true;
+    }
+
+    void c_tileImage::f_destroyTexture()
+    {
+        SDL_DestroyTexture(v_texture);
+        v_texture = nullptr;
+    }
+
+    SDL_Texture *c_tileImage::f_getTexture() const
+    {
+        return v_texture;
+    }
+
+    uint32_t c_tileImage::f_getTexel(int p_x, int p_y) const
+    {
+        return v_texels[static_cast<size_t>(p_y) * g_worldW + static_cast<size_t>(p_x)];
+    }
+
+    void c_tileImage::f_setTexel(int p_x, int p_y, uint32_t p_texel)
+    {
+        uint32_t &l_texel {v_texels[static_cast<size_t>(p_y) * g_worldW + static_cast<size_t>(p_x)]};
+
+        if (l_texel == p_texel)
+            return;
+
+        l_texel = p_texel;
+        v_dirtyRows[p_y] = true;
+    }
+
+    void c_tileImage::f_upload()
+    {
+        if (!v_texture)
+            return;
+
+        for (int l_y {}; l_y != g_worldH;)
+        {
+            if (!v_dirtyRows[l_y])
+            {
+                ++l_y;
+                continue;
+            }
+
+            int l_endY {l_y};
+
+            for (; l_endY != g_worldH && v_dirtyRows[l_endY]; ++l_endY)
+                v_dirtyRows[l_endY] = false;
+
+            SDL_Rect        l_rect   {0, l_y, g_worldW, l_endY - l_y};
+            const uint32_t *l_texels {&v_texels[static_cast<size_t>(l_y) * g_worldW]};
+            SDL_UpdateTexture(v_texture, &l_rect, l_texels, g_worldW * static_cast<int>(sizeof(uint32_t)));
+            l_y = l_endY;
+        }
+    }
+
+#endif
+
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief The header file of @c c_tileImage.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "main.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <SDL.h>
+
+
+
+
+namespace n_tdg
+{
+
+/***********************************************************************************************************************
+ * @brief An image of the world with a texel per tile, kept in a streaming texture. Only the rows whose texels have
+ * changed are uploaded.
+ * @details The texture is created by @c f_createTexture and destroyed by @c f_destroyTexture, since the image may
+ * outlive the renderer.
+ **********************************************************************************************************************/
+class c_tileImage
+{
+    private:
+
+    SDL_Texture               *v_texture   {}; //!< The texture. A @c nullptr if it hasn't been created.
+    std::vector<uint32_t>      v_texels    {}; //!< The texels, row by row, in RGBA8888.
+    std::array<bool, g_worldH> v_dirtyRows {}; //!< True for the rows which have changed since the latest upload.
+
+    public:
+
+    /*******************************************************************************************************************
+     * @brief Creates an image with every texel transparent.
+     ******************************************************************************************************************/
+    c_tileImage();
+
+    /*******************************************************************************************************************
+     * @brief Not copyable, since the image owns its texture.
+     ******************************************************************************************************************/
+    c_tileImage(const c_tileImage &) = delete;
+    c_tileImage &operator=(const c_tileImage &) = delete;
+
+    /*******************************************************************************************************************
+     * @brief Creates the texture, unless it exists. A new texture gets every texel on the next upload.
+     * @param p_renderer The renderer of the texture.
+     * @return True if the texture exists.
+     ******************************************************************************************************************/
+    bool f_createTexture(SDL_Renderer *p_renderer);
+
+    /*******************************************************************************************************************
+     * @brief Destroys the texture, if it exists.
+     ******************************************************************************************************************/
+    void f_destroyTexture();
+
+    /*******************************************************************************************************************
+     * @return The texture. A @c nullptr if it hasn't been created.
+     ******************************************************************************************************************/
+    SDL_Texture *f_getTexture() const;
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return The tile's texel, in RGBA8888.
+     ******************************************************************************************************************/
+    uint32_t f_getTexel(int p_x, int p_y) const;
+
+    /*******************************************************************************************************************
+     * @brief Sets a tile's texel, and marks its row for uploading if the texel changes.
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @param p_texel The texel, in RGBA8888.
+     ******************************************************************************************************************/
+    void f_setTexel(int p_x, int p_y, uint32_t p_texel);
+
+    /*******************************************************************************************************************
+     * @brief Uploads the rows which have changed, every run of them at once. Does nothing without a texture.
+     ******************************************************************************************************************/
+    void f_upload();
+};
+
+}
\ No newline at end of file
@@ -26,6 +26,9 @@ namespace n_tdg::n_time
         float g_scaledDTime   {};    //!< The scaled delta time.
         float g_dTimeScale    {1.f}; //!< The delta-time scale.
         
+        //! The simulation time in milliseconds. A double, so that the fractions of the scaled delta times add up.
+        double g_simTime {};
+        
         float g_tickRateCap {-1.f}; //!< The tick-rate cap. -1 means that the cap is disabled.
         
     }
@@ -48,6 +51,7 @@ namespace n_tdg::n_time
         
         g_realDTime = static_cast<float>(SDL_GetTicks64() - ls_prevTime) * .001f;
         g_scaledDTime = g_realDTime * g_dTimeScale;
+        g_simTime += static_cast<double>(g_scaledDTime) * 1000.;
         ls_prevTime = SDL_GetTicks64();
     }
     
@@ -61,6 +65,11 @@ namespace n_tdg::n_time
         return g_scaledDTime;
     }
     
+    uint64_t fg_getSimTime()
+    {
+        return static_cast<uint64_t>(g_simTime);
+    }
+    
     float fg_getDTimeScale()
     {
         return g_dTimeScale;
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 
 
 
@@ -27,6 +29,12 @@ float fg_getRealDTime();
  **********************************************************************************************************************/
 float fg_getDTime();
 
+/***********************************************************************************************************************
+ * @return The simulation time in milliseconds, which is the sum of the delta times since the start. So it stands still
+ * while the delta-time scale is 0.
+ **********************************************************************************************************************/
+uint64_t fg_getSimTime();
+
 /***********************************************************************************************************************
  * @return The delta-time scale.
  **********************************************************************************************************************/
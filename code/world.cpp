@@ -0,0 +1,483 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief For editing the world and for keeping track of the edits.
+ **********************************************************************************************************************/
+
+#if 1
+
+    #include "world.hpp"
+
+    #include <algorithm>
+    #include <array>
+    #include <vector>
+
+    using namespace std;
+
+#endif
+
+
+
+
+namespace n_tdg
+{
+
+namespace
+{
+
+constexpr size_t g_worldEditJournalSize {1024u}; //!< How many of the latest edits are remembered.
+
+uint64_t g_worldRevision        {}; //!< The world's revision. @sa fg_getWorldRevision
+uint64_t g_worldJournalRevision {}; //!< The revision since which every edit is known, unless it has been overwritten.
+
+shared_ptr<const c_worldSnapshot> g_worldSnapshot {}; //!< The snapshot of the latest revision that one was taken of.
+
+//! The latest edits' world-space tile positions, where the edit that led to the revision R is at the index R % size.
+array<pair<int, int>, g_worldEditJournalSize> g_worldEditJournal {};
+
+//! The tile offsets of a tile's neighbours, between which the regions are connected.
+constexpr array<pair<int, int>, 4> g_worldRegionNeighbours {{{1, 0}, {0, 1}, {-1, 0}, {0, -1}}};
+
+vector<uint32_t> g_worldRegionSizes     {}; //!< The number of tiles of every region. Unused regions have 0.
+vector<uint16_t> g_unusedWorldRegions   {}; //!< The regions which have no tiles, and can be given out again.
+t_worldTiles     g_worldRegionSearchIds {}; //!< The search which has visited the tile, during a split's searches.
+
+//! The tiles which the searches of a split have visited, in the order of visiting, for every search.
+array<vector<pair<int, int>>, g_worldRegionNeighbours.size()> g_worldRegionSearches {};
+
+/***********************************************************************************************************************
+ * @param p_x, p_y The world-space tile position.
+ * @return The tile's wall clearance, or 0 for a tile outside the world's boundaries.
+ **********************************************************************************************************************/
+int fg_getWallClearanceOrZero(int p_x, int p_y)
+{
+    return fg_isPosInWorldBounds(p_x, p_y) ? g_wallClearance[p_x][p_y] : 0;
+}
+
+/***********************************************************************************************************************
+ * @brief Rebuilds the wall clearance of the given area with a two-pass distance transform. The clearances around the
+ * area are used as they are, so they must be up to date.
+ * @param p_fromX, p_fromY The area's first tile position, inclusive.
+ * @param p_toX, p_toY The area's last tile position, exclusive.
+ **********************************************************************************************************************/
+void fg_rebuildWallClearance(int p_fromX, int p_fromY, int p_toX, int p_toY)
+{
+    for (int l_x {p_fromX}; l_x != p_toX; ++l_x)
+        for (int l_y {p_fromY}; l_y != p_toY; ++l_y)
+            g_wallClearance[l_x][l_y] = g_staticObjs[l_x][l_y] != 0u ? 0u : g_wallClearanceCap;
+
+    // The first pass spreads the clearances from the preceding tiles, and the second one from the following tiles.
+
+    for (int l_x {p_fromX}; l_x != p_toX; ++l_x)
+        for (int l_y {p_fromY}; l_y != p_toY; ++l_y)
+        {
+            unsigned char &l_clearance {g_wallClearance[l_x][l_y]};
+
+            int l_min
+            {
+                min
+                ({
+                    fg_getWallClearanceOrZero(l_x - 1, l_y - 1),
+                    fg_getWallClearanceOrZero(l_x - 1, l_y),
+                    fg_getWallClearanceOrZero(l_x - 1, l_y + 1),
+                    fg_getWallClearanceOrZero(l_x,     l_y - 1)
+                })
+            };
+
+            l_clearance = static_cast<unsigned char>(min(static_cast<int>(l_clearance), l_min + 1));
+        }
+
+    for (int l_x {p_toX - 1}; l_x != p_fromX - 1; --l_x)
+        for (int l_y {p_toY - 1}; l_y != p_fromY - 1; --l_y)
+        {
+            unsigned char &l_clearance {g_wallClearance[l_x][l_y]};
+
+            int l_min
+            {
+                min
+                ({
+                    fg_getWallClearanceOrZero(l_x + 1, l_y + 1),
+                    fg_getWallClearanceOrZero(l_x + 1, l_y),
+                    fg_getWallClearanceOrZero(l_x + 1, l_y - 1),
+                    fg_getWallClearanceOrZero(l_x,     l_y + 1)
+                })
+            };
+
+            l_clearance = static_cast<unsigned char>(min(static_cast<int>(l_clearance), l_min + 1));
+        }
+
+    for (int l_x {p_fromX}; l_x != p_toX; ++l_x)
+        for (int l_y {p_fromY}; l_y != p_toY; ++l_y)
+        {
+            uint64_t  l_bit          {uint64_t {1u} << (l_y % 64)};
+            uint64_t &l_freeWord     {g_freeTileBits[l_x][l_y / 64]};
+            uint64_t &l_nearWallWord {g_nearWallTileBits[l_x][l_y / 64]};
+
+            l_freeWord     = g_staticObjs[l_x][l_y] == 0u ? l_freeWord | l_bit : l_freeWord & ~l_bit;
+            l_nearWallWord = fg_isPosNearWall(l_x, l_y)   ? l_nearWallWord | l_bit : l_nearWallWord & ~l_bit;
+        }
+}
+
+/***********************************************************************************************************************
+ * @return A region which has no tiles.
+ **********************************************************************************************************************/
+uint16_t fg_getUnusedWorldRegion()
+{
+    if (!g_unusedWorldRegions.empty())
+    {
+        uint16_t l_region {g_unusedWorldRegions.back()};
+        g_unusedWorldRegions.pop_back();
+        return l_region;
+    }
+
+    // Neighbouring free tiles share a region, so there are at most half as many regions as there are tiles.
+    static_assert(g_worldW * g_worldH / 2 < UINT16_MAX);
+
+    g_worldRegionSizes.push_back(0u);
+    return static_cast<uint16_t>(g_worldRegionSizes.size() - 1u);
+}
+
+/***********************************************************************************************************************
+ * @brief Moves tiles from a region to another.
+ * @param p_fromRegion The region which loses the tiles. Given out again if it's left without tiles.
+ * @param p_toRegion The region which gets the tiles, or @c g_noWorldRegion if the tiles got a static object.
+ * @param p_count The number of tiles.
+ **********************************************************************************************************************/
+void fg_moveWorldRegionTiles(uint16_t p_fromRegion, uint16_t p_toRegion, uint32_t p_count)
+{
+    if (p_toRegion != g_noWorldRegion)
+        g_worldRegionSizes[p_toRegion] += p_count;
+
+    g_worldRegionSizes[p_fromRegion] -= p_count;
+
+    if (g_worldRegionSizes[p_fromRegion] == 0u)
+        g_unusedWorldRegions.push_back(p_fromRegion);
+}
+
+/***********************************************************************************************************************
+ * @brief Gives a region to every free tile which is connected to the given tile and isn't in that region yet.
+ * @param p_x, p_y The world-space tile position of a free tile.
+ * @param p_region The region.
+ * @return The number of tiles whose region was changed.
+ **********************************************************************************************************************/
+uint32_t fg_fillWorldRegion(int p_x, int p_y, uint16_t p_region)
+{
+    vector<pair<int, int>> &l_positions {g_worldRegionSearches.front()};
+    uint32_t                l_count     {};
+
+    l_positions.assign(1u, {p_x, p_y});
+    g_worldRegions[p_x][p_y] = p_region;
+
+    while (!l_positions.empty())
+    {
+        auto [l_x, l_y] {l_positions.back()};
+        l_positions.pop_back();
+        ++l_count;
+
+        for (auto [l_offsetX, l_offsetY] : g_worldRegionNeighbours)
+        {
+            int l_neighbourX {l_x + l_offsetX};
+            int l_neighbourY {l_y + l_offsetY};
+
+            if
+            (
+                fg_isPosInWorldBounds(l_neighbourX, l_neighbourY) &&
+                g_staticObjs[l_neighbourX][l_neighbourY] == 0u &&
+                g_worldRegions[l_neighbourX][l_neighbourY] != p_region
+            )
+            {
+                g_worldRegions[l_neighbourX][l_neighbourY] = p_region;
+                l_positions.push_back({l_neighbourX, l_neighbourY});
+            }
+        }
+    }
+
+    return l_count;
+}
+
+/***********************************************************************************************************************
+ * @brief Gives every free tile a region from scratch.
+ **********************************************************************************************************************/
+void fg_rebuildWorldRegions()
+{
+    for (auto &l_column : g_worldRegions)
+        l_column.fill(g_noWorldRegion);
+
+    g_worldRegionSizes.assign(1u, 0u);
+    g_unusedWorldRegions.clear();
+
+    for (int l_x {}; l_x != g_worldW; ++l_x)
+        for (int l_y {}; l_y != g_worldH; ++l_y)
+            if (g_staticObjs[l_x][l_y] == 0u && g_worldRegions[l_x][l_y] == g_noWorldRegion)
+            {
+                uint16_t l_region {fg_getUnusedWorldRegion()};
+                g_worldRegionSizes[l_region] = fg_fillWorldRegion(l_x, l_y, l_region);
+            }
+}
+
+/***********************************************************************************************************************
+ * @brief Updates the regions after a tile has become free. The tile joins its neighbours' region, and the regions of
+ * the neighbours are merged into the largest one.
+ * @param p_x, p_y The tile's world-space position.
+ **********************************************************************************************************************/
+void fg_joinWorldRegions(int p_x, int p_y)
+{
+    uint16_t l_region {g_noWorldRegion};
+
+    for (auto [l_offsetX, l_offsetY] : g_worldRegionNeighbours)
+        if (fg_isPosInWorldBounds(p_x + l_offsetX, p_y + l_offsetY))
+        {
+            uint16_t l_neighbourRegion {g_worldRegions[p_x + l_offsetX][p_y + l_offsetY]};
+
+            if
+            (
+                l_neighbourRegion != g_noWorldRegion &&
+                (l_region == g_noWorldRegion || g_worldRegionSizes[l_neighbourRegion] > g_worldRegionSizes[l_region])
+            )
+            {
+                l_region = l_neighbourRegion;
+            }
+        }
+
+    if (l_region == g_noWorldRegion)
+        l_region = fg_getUnusedWorldRegion();
+
+    g_worldRegions[p_x][p_y] = l_region;
+    ++g_worldRegionSizes[l_region];
+
+    // The other regions are only connected to the largest one through the tile, so filling them stays inside them.
+    for (auto [l_offsetX, l_offsetY] : g_worldRegionNeighbours)
+    {
+        int l_x {p_x + l_offsetX};
+        int l_y {p_y + l_offsetY};
+
+        if (!fg_isPosInWorldBounds(l_x, l_y))
+            continue;
+
+        uint16_t l_neighbourRegion {g_worldRegions[l_x][l_y]};
+
+        if (l_neighbourRegion != g_noWorldRegion && l_neighbourRegion != l_region)
+            fg_moveWorldRegionTiles(l_neighbourRegion, l_region, fg_fillWorldRegion(l_x, l_y, l_region));
+    }
+}
+
+/***********************************************************************************************************************
+ * @brief Updates the regions after a tile has got a static object, which may split its region. A search is run from
+ * every free neighbour at once, a tile at a time from each one in turn. Searches that meet are connected, and a
+ * group of connected searches that runs out of tiles before meeting the others has been split off, and gets a new
+ * region. This only visits about as many tiles as the pieces that are split off have, instead of the whole region.
+ * @param p_x, p_y The tile's world-space position.
+ **********************************************************************************************************************/
+void fg_splitWorldRegion(int p_x, int p_y)
+{
+    uint16_t l_region {g_worldRegions[p_x][p_y]};
+
+    g_worldRegions[p_x][p_y] = g_noWorldRegion;
+    fg_moveWorldRegionTiles(l_region, g_noWorldRegion, 1u);
+
+    // The searches are numbered from 1 in the tiles, so that 0 is left for the tiles that haven't been visited. The
+    // searches that meet are joined into groups, which are kept as a tree of searches whose root is the group's ID.
+    array<size_t, g_worldRegionNeighbours.size()> l_groups      {}; //!< The parent of every search in its group.
+    array<size_t, g_worldRegionNeighbours.size()> l_nextIndices {}; //!< Every search's next tile to spread.
+    array<bool, g_worldRegionNeighbours.size()>   l_isSplitOff  {}; //!< Whether the search's piece has been split off.
+    size_t                                        l_searchCount {};
+
+    for (auto [l_offsetX, l_offsetY] : g_worldRegionNeighbours)
+    {
+        int l_x {p_x + l_offsetX};
+        int l_y {p_y + l_offsetY};
+
+        if (!fg_isPosInWorldBounds(l_x, l_y) || g_staticObjs[l_x][l_y] != 0u)
+            continue;
+
+        g_worldRegionSearches[l_searchCount].assign(1u, {l_x, l_y});
+        g_worldRegionSearchIds[l_x][l_y] = static_cast<unsigned char>(l_searchCount + 1u);
+        l_groups[l_searchCount] = l_searchCount;
+        l_nextIndices[l_searchCount] = 0u;
+        ++l_searchCount;
+    }
+
+    auto fl_getGroup = [&](size_t p_search)
+    {
+        while (l_groups[p_search] != p_search)
+            p_search = l_groups[p_search];
+
+        return p_search;
+    };
+
+    auto fl_getGroupCount = [&]()
+    {
+        size_t l_count {};
+
+        for (size_t l_search {}; l_search != l_searchCount; ++l_search)
+            if (!l_isSplitOff[l_search] && fl_getGroup(l_search) == l_search)
+                ++l_count;
+
+        return l_count;
+    };
+
+    // Searches until all the searches are connected, or only one group is still searching.
+    while (fl_getGroupCount() > 1u)
+    {
+        for (size_t l_search {}; l_search != l_searchCount; ++l_search)
+        {
+            vector<pair<int, int>> &l_positions {g_worldRegionSearches[l_search]};
+
+            if (l_nextIndices[l_search] == l_positions.size())
+                continue;
+
+            auto [l_x, l_y] {l_positions[l_nextIndices[l_search]++]};
+
+            for (auto [l_offsetX, l_offsetY] : g_worldRegionNeighbours)
+            {
+                int l_neighbourX {l_x + l_offsetX};
+                int l_neighbourY {l_y + l_offsetY};
+
+                if
+                (
+                    !fg_isPosInWorldBounds(l_neighbourX, l_neighbourY) ||
+                    g_staticObjs[l_neighbourX][l_neighbourY] != 0u
+                )
+                {
+                    continue;
+                }
+
+                unsigned char &l_searchId {g_worldRegionSearchIds[l_neighbourX][l_neighbourY]};
+
+                if (l_searchId == 0u)
+                {
+                    l_searchId = static_cast<unsigned char>(l_search + 1u);
+                    l_positions.push_back({l_neighbourX, l_neighbourY});
+                }
+                else
+                {
+                    l_groups[fl_getGroup(l_searchId - 1u)] = fl_getGroup(l_search);
+                }
+            }
+        }
+
+        // A group whose every search has run out of tiles has visited a whole piece of the region, which is split
+        // off into a new region.
+        for (size_t l_group {}; l_group != l_searchCount; ++l_group)
+        {
+            if (l_isSplitOff[l_group] || fl_getGroup(l_group) != l_group)
+                continue;
+
+            bool l_isDone {true};
+
+            for (size_t l_search {}; l_search != l_searchCount; ++l_search)
+                if (fl_getGroup(l_search) == l_group)
+                    l_isDone = l_isDone && l_nextIndices[l_search] == g_worldRegionSearches[l_search].size();
+
+            if (!l_isDone || fl_getGroupCount() == 1u)
+                continue;
+
+            uint16_t l_newRegion {fg_getUnusedWorldRegion()};
+            uint32_t l_count     {};
+
+            for (size_t l_search {}; l_search != l_searchCount; ++l_search)
+                if (fl_getGroup(l_search) == l_group)
+                {
+                    for (auto [l_x, l_y] : g_worldRegionSearches[l_search])
+                        g_worldRegions[l_x][l_y] = l_newRegion;
+
+                    l_count += static_cast<uint32_t>(g_worldRegionSearches[l_search].size());
+                    l_isSplitOff[l_search] = true;
+                }
+
+            fg_moveWorldRegionTiles(l_region, l_newRegion, l_count);
+        }
+    }
+
+    for (size_t l_search {}; l_search != l_searchCount; ++l_search)
+        for (auto [l_x, l_y] : g_worldRegionSearches[l_search])
+            g_worldRegionSearchIds[l_x][l_y] = 0u;
+}
+
+}
+
+array<array<unsigned char, g_worldH>, g_worldW> g_wallClearance {};
+t_worldTileBits g_freeTileBits {};
+t_worldTileBits g_nearWallTileBits {};
+t_worldRegions g_worldRegions {};
+
+void fg_setStaticObj(int p_x, int p_y, unsigned char p_obj)
+{
+    unsigned char &l_staticObj {g_staticObjs[p_x][p_y]};
+
+    // Repainting a tile with the same object is common while the pointer is held down, and changes nothing.
+    if (l_staticObj == p_obj)
+        return;
+
+    bool l_wasFree {l_staticObj == 0u};
+
+    l_staticObj = p_obj;
+    ++g_worldRevision;
+    g_worldEditJournal[g_worldRevision % g_worldEditJournalSize] = {p_x, p_y};
+
+    // The edit can't change the capped clearance of a tile that is farther away than the cap.
+    fg_rebuildWallClearance
+    (
+        max(0,        p_x - g_wallClearanceCap),
+        max(0,        p_y - g_wallClearanceCap),
+        min(g_worldW, p_x + g_wallClearanceCap + 1),
+        min(g_worldH, p_y + g_wallClearanceCap + 1)
+    );
+
+    if (l_wasFree && p_obj != 0u)
+        fg_splitWorldRegion(p_x, p_y);
+    else if (!l_wasFree && p_obj == 0u)
+        fg_joinWorldRegions(p_x, p_y);
+}
+
+void fg_markWholeWorldChanged()
+{
+    ++g_worldRevision;
+    g_worldJournalRevision = g_worldRevision;
+    fg_rebuildWallClearance(0, 0, g_worldW, g_worldH);
+    fg_rebuildWorldRegions();
+}
+
+uint64_t fg_getWorldRevision()
+{
+    return g_worldRevision;
+}
+
+bool fg_getWorldEditsSince(uint64_t p_revision, vector<pair<int, int>> &p_positions)
+{
+    if (p_revision < g_worldJournalRevision || g_worldRevision - p_revision > g_worldEditJournalSize)
+        return false;
+
+    for (uint64_t l_revision {p_revision + 1u}; l_revision <= g_worldRevision; ++l_revision)
+        p_positions.push_back(g_worldEditJournal[l_revision % g_worldEditJournalSize]);
+
+    return true;
+}
+
+c_worldView c_worldSnapshot::f_getView() const
+{
+    return {v_staticObjs, v_wallClearance, v_freeTileBits, v_nearWallTileBits, v_regions, v_revision};
+}
+
+c_worldView fg_getLiveWorldView()
+{
+    return {g_staticObjs, g_wallClearance, g_freeTileBits, g_nearWallTileBits, g_worldRegions, g_worldRevision};
+}
+
+shared_ptr<const c_worldSnapshot> fg_getWorldSnapshot()
+{
+    if (!g_worldSnapshot || g_worldSnapshot->v_revision != g_worldRevision)
+    {
+        shared_ptr<c_worldSnapshot> l_snapshot {make_shared<c_worldSnapshot>()};
+        l_snapshot->v_staticObjs = g_staticObjs;
+        l_snapshot->v_wallClearance = g_wallClearance;
+        l_snapshot->v_freeTileBits = g_freeTileBits;
+        l_snapshot->v_nearWallTileBits = g_nearWallTileBits;
+        l_snapshot->v_regions = g_worldRegions;
+        l_snapshot->v_revision = g_worldRevision;
+        g_worldSnapshot = move(l_snapshot);
+    }
+
+    return g_worldSnapshot;
+}
+
+}
\ No newline at end of file
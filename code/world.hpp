@@ -0,0 +1,284 @@
+/***********************************************************************************************************************
+ * @file
+ * @brief For editing the world and for keeping track of the edits.
+ **********************************************************************************************************************/
+
+#pragma once
+
+#include "main.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+
+
+namespace n_tdg
+{
+
+//! The highest value of the wall clearance. Higher clearances are stored as this. @sa g_wallClearance
+constexpr unsigned char g_wallClearanceCap {15u};
+
+/***********************************************************************************************************************
+ * @brief The wall clearance of every tile: the Chebyshev distance to the nearest tile with a static object, counting
+ * the tiles outside the world's boundaries as such. A tile with a static object has 0 clearance, and a tile next to
+ * one has 1. Capped at @c g_wallClearanceCap. Kept up to date by @c fg_setStaticObj, and read-only elsewhere.
+ **********************************************************************************************************************/
+extern std::array<std::array<unsigned char, g_worldH>, g_worldW> g_wallClearance;
+
+/***********************************************************************************************************************
+ * @brief Checks whether a tile is near a wall, meaning that the tile or one of its 8 neighbours has a static object
+ * or is outside the world's boundaries.
+ * @param p_x, p_y The world-space tile position. Must be inside the world's boundaries.
+ * @return True if the tile is near a wall.
+ **********************************************************************************************************************/
+inline bool fg_isPosNearWall(int p_x, int p_y)
+{
+    return g_wallClearance[p_x][p_y] <= 1u;
+}
+
+/***********************************************************************************************************************
+ * @brief Sets a tile's static object. Every write to @c g_staticObjs after the world's generation should go through
+ * this, so that the world's revision and @c g_wallClearance stay up to date.
+ * @param p_x, p_y The world-space tile position. Must be inside the world's boundaries.
+ * @param p_obj The new static object.
+ * @sa fg_getWorldRevision
+ **********************************************************************************************************************/
+void fg_setStaticObj(int p_x, int p_y, unsigned char p_obj);
+
+/***********************************************************************************************************************
+ * @brief Advances the world's revision and rebuilds @c g_wallClearance after @c g_staticObjs has been rewritten as a
+ * whole, such as after the world's generation.
+ **********************************************************************************************************************/
+void fg_markWholeWorldChanged();
+
+/***********************************************************************************************************************
+ * @return The world's revision, which advances on every change of @c g_staticObjs. Anything derived from the world
+ * is up to date as long as the revision it was derived at equals this.
+ **********************************************************************************************************************/
+uint64_t fg_getWorldRevision();
+
+/***********************************************************************************************************************
+ * @brief Gets the tiles that have been edited since the given revision, so that things derived from the world can be
+ * updated locally instead of as a whole. Only a limited number of the latest edits is remembered.
+ * @param p_revision The revision that the caller is up to date with.
+ * @param p_positions Gets the world-space tile position of every edit in order. A tile can appear more than once.
+ * @return False if the edits are no longer known, such as after @c fg_markWholeWorldChanged, in which case
+ * everything must be updated.
+ **********************************************************************************************************************/
+bool fg_getWorldEditsSince(uint64_t p_revision, std::vector<std::pair<int, int>> &p_positions);
+
+//! A value for every tile of the world, indexed with [X][Y].
+using t_worldTiles = std::array<std::array<unsigned char, g_worldH>, g_worldW>;
+
+static_assert(g_worldH % 64 == 0);
+
+constexpr int g_worldBitWordsH {g_worldH / 64}; //!< The number of 64-bit words in a column of @c t_worldTileBits.
+
+//! A bit for every tile of the world, packed so that the column X holds the tile (X, Y) in the bit Y % 64 of the word
+//! Y / 64. Lets whole columns of tiles be tested and combined a word at a time.
+using t_worldTileBits = std::array<std::array<uint64_t, g_worldBitWordsH>, g_worldW>;
+
+/***********************************************************************************************************************
+ * @brief The tiles without a static object, as bits. Kept up to date with @c g_wallClearance.
+ **********************************************************************************************************************/
+extern t_worldTileBits g_freeTileBits;
+
+/***********************************************************************************************************************
+ * @brief The tiles that are near a wall, as in @c fg_isPosNearWall, as bits. Kept up to date with
+ * @c g_wallClearance.
+ **********************************************************************************************************************/
+extern t_worldTileBits g_nearWallTileBits;
+
+//! The region of every tile, indexed with [X][Y]. @sa g_worldRegions
+using t_worldRegions = std::array<std::array<uint16_t, g_worldH>, g_worldW>;
+
+constexpr uint16_t g_noWorldRegion {0u}; //!< The region of the tiles with a static object.
+
+/***********************************************************************************************************************
+ * @brief The connected region of every tile. Two free tiles have the same region if and only if they're connected by
+ * steps between neighbouring free tiles, not counting the health rules of the pathfinding. So a tile in another
+ * region is never reachable, but a tile in the same region may still be. Kept up to date by @c fg_setStaticObj, and
+ * read-only elsewhere.
+ **********************************************************************************************************************/
+extern t_worldRegions g_worldRegions;
+
+/***********************************************************************************************************************
+ * @brief Read access to the static objects and the wall clearance of either the live world or a snapshot of it. Code
+ * which may run outside the main thread reads the world only through this.
+ **********************************************************************************************************************/
+class c_worldView
+{
+    private:
+
+    const t_worldTiles    *v_staticObjs;       //!< The static objects.
+    const t_worldTiles    *v_wallClearance;    //!< The wall clearance, as in @c g_wallClearance.
+    const t_worldTileBits *v_freeTileBits;     //!< The free tiles, as in @c g_freeTileBits.
+    const t_worldTileBits *v_nearWallTileBits; //!< The tiles near a wall, as in @c g_nearWallTileBits.
+    const t_worldRegions  *v_regions;          //!< The regions, as in @c g_worldRegions.
+    uint64_t               v_revision;         //!< The world's revision.
+
+    public:
+
+    /*******************************************************************************************************************
+     * @param p_staticObjs The static objects. Must outlive the view.
+     * @param p_wallClearance The wall clearance of the static objects. Must outlive the view.
+     * @param p_freeTileBits The free tiles of the static objects. Must outlive the view.
+     * @param p_nearWallTileBits The tiles near a wall of the static objects. Must outlive the view.
+     * @param p_regions The regions of the static objects. Must outlive the view.
+     * @param p_revision The world's revision that the static objects are of.
+     ******************************************************************************************************************/
+    c_worldView
+    (
+        const t_worldTiles &p_staticObjs, const t_worldTiles &p_wallClearance, const t_worldTileBits &p_freeTileBits,
+        const t_worldTileBits &p_nearWallTileBits, const t_worldRegions &p_regions, uint64_t p_revision
+    );
+
+    /*******************************************************************************************************************
+     * @return True if the view is of the live world, which may only be read on the main thread.
+     ******************************************************************************************************************/
+    bool f_isLive() const;
+
+    /*******************************************************************************************************************
+     * @return The world's revision that the view is of. A view of the live world keeps the revision at which it was
+     * made, so it should be made again after an edit.
+     ******************************************************************************************************************/
+    uint64_t f_getRevision() const;
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position.
+     * @return True if the tile is inside the world's boundaries and has no static object.
+     ******************************************************************************************************************/
+    bool f_isFree(int p_x, int p_y) const;
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return The tile's wall clearance.
+     ******************************************************************************************************************/
+    unsigned char f_getWallClearance(int p_x, int p_y) const;
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return True if the tile is near a wall, as in @c fg_isPosNearWall.
+     ******************************************************************************************************************/
+    bool f_isPosNearWall(int p_x, int p_y) const;
+
+    /*******************************************************************************************************************
+     * @return The free tiles, as bits.
+     ******************************************************************************************************************/
+    const t_worldTileBits &f_getFreeTileBits() const;
+
+    /*******************************************************************************************************************
+     * @return The tiles near a wall, as bits.
+     ******************************************************************************************************************/
+    const t_worldTileBits &f_getNearWallTileBits() const;
+
+    /*******************************************************************************************************************
+     * @param p_x, p_y A world-space tile position inside the world's boundaries.
+     * @return The tile's region, as in @c g_worldRegions.
+     ******************************************************************************************************************/
+    uint16_t f_getRegion(int p_x, int p_y) const;
+
+    /*******************************************************************************************************************
+     * @param p_fromX, p_fromY A world-space tile position inside the world's boundaries.
+     * @param p_toX, p_toY A world-space tile position inside the world's boundaries.
+     * @return True if the second tile can't be reached from the first one, because they're free tiles in different
+     * regions, or the second tile has a static object while the first one doesn't. A search from a tile with a
+     * static object may still leave it, so such a tile is never known to be cut off.
+     * @sa g_worldRegions
+     ******************************************************************************************************************/
+    bool f_isCutOff(int p_fromX, int p_fromY, int p_toX, int p_toY) const;
+};
+
+/***********************************************************************************************************************
+ * @brief An immutable copy of the world at a revision, which can be read from any thread.
+ **********************************************************************************************************************/
+class c_worldSnapshot
+{
+    public:
+
+    t_worldTiles    v_staticObjs       {}; //!< The static objects.
+    t_worldTiles    v_wallClearance    {}; //!< The wall clearance.
+    t_worldTileBits v_freeTileBits     {}; //!< The free tiles.
+    t_worldTileBits v_nearWallTileBits {}; //!< The tiles near a wall.
+    t_worldRegions  v_regions          {}; //!< The regions.
+    uint64_t        v_revision         {}; //!< The world's revision at the time of copying.
+
+    /*******************************************************************************************************************
+     * @return A view of the snapshot. Valid for as long as the snapshot is.
+     ******************************************************************************************************************/
+    c_worldView f_getView() const;
+};
+
+/***********************************************************************************************************************
+ * @return A view of the live world. May only be used on the main thread.
+ **********************************************************************************************************************/
+c_worldView fg_getLiveWorldView();
+
+/***********************************************************************************************************************
+ * @return A snapshot of the world at the current revision. The same snapshot is shared until the world changes, so
+ * this only copies the world once per revision. May only be called on the main thread.
+ **********************************************************************************************************************/
+std::shared_ptr<const c_worldSnapshot> fg_getWorldSnapshot();
+
+inline c_worldView::c_worldView
+(
+    const t_worldTiles &p_staticObjs, const t_worldTiles &p_wallClearance, const t_worldTileBits &p_freeTileBits,
+    const t_worldTileBits &p_nearWallTileBits, const t_worldRegions &p_regions, uint64_t p_revision
+) :
+v_staticObjs {&p_staticObjs}, v_wallClearance {&p_wallClearance}, v_freeTileBits {&p_freeTileBits},
+v_nearWallTileBits {&p_nearWallTileBits}, v_regions {&p_regions}, v_revision {p_revision}
+{
+
+}
+
+inline bool c_worldView::f_isLive() const
+{
+    return v_staticObjs == &g_staticObjs;
+}
+
+inline uint64_t c_worldView::f_getRevision() const
+{
+    return v_revision;
+}
+
+inline bool c_worldView::f_isFree(int p_x, int p_y) const
+{
+    return fg_isPosInWorldBounds(p_x, p_y) && (*v_staticObjs)[p_x][p_y] == 0u;
+}
+
+inline unsigned char c_worldView::f_getWallClearance(int p_x, int p_y) const
+{
+    return (*v_wallClearance)[p_x][p_y];
+}
+
+inline bool c_worldView::f_isPosNearWall(int p_x, int p_y) const
+{
+    return (*v_wallClearance)[p_x][p_y] <= 1u;
+}
+
+inline const t_worldTileBits &c_worldView::f_getFreeTileBits() const
+{
+    return *v_freeTileBits;
+}
+
+inline const t_worldTileBits &c_worldView::f_getNearWallTileBits() const
+{
+    return *v_nearWallTileBits;
+}
+
+inline uint16_t c_worldView::f_getRegion(int p_x, int p_y) const
+{
+    return (*v_regions)[p_x][p_y];
+}
+
+inline bool c_worldView::f_isCutOff(int p_fromX, int p_fromY, int p_toX, int p_toY) const
+{
+    uint16_t l_fromRegion {(*v_regions)[p_fromX][p_fromY]};
+    return l_fromRegion != g_noWorldRegion && (*v_regions)[p_toX][p_toY] != l_fromRegion;
+}
+
+}
\ No newline at end of file